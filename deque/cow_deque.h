@@ -0,0 +1,257 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "deque.h"
+
+template <typename T, size_t BuffSz = DefaultBuffSz<T>()>
+class CowDeque {
+  static_assert(std::has_single_bit(BuffSz),
+                "CowDeque block size must be a power of two");
+
+public:
+  CowDeque() = default;
+  CowDeque(const CowDeque& deque) = default;
+  CowDeque(CowDeque&& deque) noexcept;
+  ~CowDeque() = default;
+
+  CowDeque& operator=(const CowDeque& deque) = default;
+  CowDeque& operator=(CowDeque&& deque) noexcept;
+
+  CowDeque snapshot() const { return *this; }
+
+  const T& operator[](size_t idx) const;
+  const T& at(size_t idx) const;
+  T& mutable_at(size_t idx);
+
+  const T& front() const { return operator[](0); }
+  const T& back() const { return operator[](size() - 1); }
+
+  void push_back(const T& val);
+  void push_back(T&& val);
+  void push_front(const T& val);
+  void push_front(T&& val);
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  template <typename... Args>
+  T& emplace_front(Args&&... args);
+  void pop_back();
+  void pop_front();
+
+  size_t size() const { return end_ - begin_; }
+  bool empty() const { return begin_ == end_; }
+
+  template <typename Function>
+  void for_each_segment(Function function) const;
+
+private:
+  static const size_t kBuffSz = BuffSz;
+  static const size_t kShift = std::countr_zero(BuffSz);
+  static const size_t kMask = BuffSz - 1;
+
+  struct Block;
+  using BlockPtr = std::shared_ptr<Block>;
+
+  std::vector<BlockPtr> map_;
+  size_t begin_{0};
+  size_t end_{0};
+
+  static size_t node_of(size_t pos) { return pos >> kShift; }
+  static size_t offset_of(size_t pos) { return pos & kMask; }
+
+  static BlockPtr clone_block(const Block& block);
+  Block& writable_block(size_t node, size_t empty_pos);
+  void grow_map(bool add_at_front);
+};
+
+template <typename T, size_t BuffSz>
+struct CowDeque<T, BuffSz>::Block {
+  size_t lo;
+  size_t hi;
+  alignas(T) unsigned char storage[kBuffSz * sizeof(T)];
+
+  Block(size_t pos) : lo(pos), hi(pos) {}
+  Block(const Block& block) = delete;
+  Block& operator=(const Block& block) = delete;
+  ~Block() {
+    for (size_t i = lo; i < hi; ++i) {
+      data()[i].~T();
+    }
+  }
+
+  T* data() { return std::launder(reinterpret_cast<T*>(storage)); }
+  const T* data() const {
+    return std::launder(reinterpret_cast<const T*>(storage));
+  }
+};
+
+template <typename T, size_t BuffSz>
+CowDeque<T, BuffSz>::CowDeque(CowDeque&& deque) noexcept
+    : map_(std::move(deque.map_)), begin_(deque.begin_), end_(deque.end_) {
+  deque.map_.clear();
+  deque.begin_ = 0;
+  deque.end_ = 0;
+}
+
+template <typename T, size_t BuffSz>
+CowDeque<T, BuffSz>& CowDeque<T, BuffSz>::operator=(
+    CowDeque&& deque) noexcept {
+  CowDeque tmp(std::move(deque));
+  std::swap(map_, tmp.map_);
+  std::swap(begin_, tmp.begin_);
+  std::swap(end_, tmp.end_);
+  return *this;
+}
+
+template <typename T, size_t BuffSz>
+const T& CowDeque<T, BuffSz>::operator[](size_t idx) const {
+  size_t pos = begin_ + idx;
+  return map_[node_of(pos)]->data()[offset_of(pos)];
+}
+
+template <typename T, size_t BuffSz>
+const T& CowDeque<T, BuffSz>::at(size_t idx) const {
+  if (idx >= size()) {
+    throw std::out_of_range("criminal scum");
+  }
+  return operator[](idx);
+}
+
+template <typename T, size_t BuffSz>
+T& CowDeque<T, BuffSz>::mutable_at(size_t idx) {
+  if (idx >= size()) {
+    throw std::out_of_range("criminal scum");
+  }
+  size_t pos = begin_ + idx;
+  return writable_block(node_of(pos), 0).data()[offset_of(pos)];
+}
+
+template <typename T, size_t BuffSz>
+typename CowDeque<T, BuffSz>::BlockPtr CowDeque<T, BuffSz>::clone_block(
+    const Block& block) {
+  auto copy = std::make_shared<Block>(block.lo);
+  for (size_t i = block.lo; i < block.hi; ++i) {
+    new (copy->data() + i) T(block.data()[i]);
+    ++copy->hi;
+  }
+  return copy;
+}
+
+template <typename T, size_t BuffSz>
+typename CowDeque<T, BuffSz>::Block& CowDeque<T, BuffSz>::writable_block(
+    size_t node, size_t empty_pos) {
+  BlockPtr& block = map_[node];
+  if (block == nullptr) {
+    block = std::make_shared<Block>(empty_pos);
+  } else if (block.use_count() > 1) {
+    block = clone_block(*block);
+  } else {
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *block;
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::grow_map(bool add_at_front) {
+  size_t old_num_nodes = empty() ? 0 : node_of(end_ - 1) - node_of(begin_) + 1;
+  size_t new_size = 2 * old_num_nodes + 2;
+  size_t new_start = add_at_front ? new_size - old_num_nodes - 1 : 1;
+  std::vector<BlockPtr> new_map(new_size);
+  for (size_t i = 0; i < old_num_nodes; ++i) {
+    new_map[new_start + i] = std::move(map_[node_of(begin_) + i]);
+  }
+  std::swap(map_, new_map);
+  size_t len = end_ - begin_;
+  begin_ = (new_start << kShift) + offset_of(begin_);
+  end_ = begin_ + len;
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::push_back(const T& val) {
+  emplace_back(val);
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::push_back(T&& val) {
+  emplace_back(std::move(val));
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::push_front(const T& val) {
+  emplace_front(val);
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::push_front(T&& val) {
+  emplace_front(std::move(val));
+}
+
+template <typename T, size_t BuffSz>
+template <typename... Args>
+T& CowDeque<T, BuffSz>::emplace_back(Args&&... args) {
+  if (map_.empty() || node_of(end_) >= map_.size()) {
+    grow_map(false);
+  }
+  Block& block = writable_block(node_of(end_), offset_of(end_));
+  T* item = new (block.data() + block.hi) T(std::forward<Args>(args)...);
+  ++block.hi;
+  ++end_;
+  return *item;
+}
+
+template <typename T, size_t BuffSz>
+template <typename... Args>
+T& CowDeque<T, BuffSz>::emplace_front(Args&&... args) {
+  if (map_.empty() || begin_ == 0) {
+    grow_map(true);
+  }
+  Block& block =
+      writable_block(node_of(begin_ - 1), offset_of(begin_ - 1) + 1);
+  T* item = new (block.data() + block.lo - 1) T(std::forward<Args>(args)...);
+  --block.lo;
+  --begin_;
+  return *item;
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::pop_back() {
+  BlockPtr& block = map_[node_of(end_ - 1)];
+  if (block->hi - block->lo == 1) {
+    block.reset();
+  } else {
+    Block& writable = writable_block(node_of(end_ - 1), 0);
+    --writable.hi;
+    writable.data()[writable.hi].~T();
+  }
+  --end_;
+}
+
+template <typename T, size_t BuffSz>
+void CowDeque<T, BuffSz>::pop_front() {
+  BlockPtr& block = map_[node_of(begin_)];
+  if (block->hi - block->lo == 1) {
+    block.reset();
+  } else {
+    Block& writable = writable_block(node_of(begin_), 0);
+    writable.data()[writable.lo].~T();
+    ++writable.lo;
+  }
+  ++begin_;
+}
+
+template <typename T, size_t BuffSz>
+template <typename Function>
+void CowDeque<T, BuffSz>::for_each_segment(Function function) const {
+  if (empty()) {
+    return;
+  }
+  for (size_t node = node_of(begin_); node <= node_of(end_ - 1); ++node) {
+    const Block& block = *map_[node];
+    function(block.data() + block.lo, block.data() + block.hi);
+  }
+}
@@ -1,20 +1,57 @@
 #pragma once
+#include <algorithm>
+#include <bit>
 #include <cstdio>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+const size_t kBlockBytes = 512;
+const size_t kCacheLineSz = 64;
+
+struct DequeMemoryStats {
+  size_t elements;
+  size_t blocks;
+  size_t cached_blocks;
+  size_t peak_blocks;
+  size_t map_slots;
+  size_t bytes;
+};
+
 template <typename T>
+constexpr size_t DefaultBuffSz() {
+  return sizeof(T) < kBlockBytes ? std::bit_floor(kBlockBytes / sizeof(T)) : 1;
+}
+
+template <typename T, typename Allocator = std::allocator<T>,
+          size_t BuffSz = DefaultBuffSz<T>()>
 class Deque {
+  static_assert(std::has_single_bit(BuffSz),
+                "Deque block size must be a power of two");
+
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+  using allocator_traits = std::allocator_traits<allocator_type>;
+  using map_allocator_type =
+      typename allocator_traits::template rebind_alloc<T*>;
+
 public:
   Deque() = default;
-  Deque(const Deque<T>& deque);
-  Deque(size_t n);
-  Deque(size_t n, const T& val);
+  Deque(const Allocator& alloc) : alloc_(alloc) {}
+  Deque(const Deque& deque);
+  Deque(const Deque& deque, const Allocator& alloc);
+  Deque(Deque&& deque) noexcept;
+  Deque(size_t n, const Allocator& alloc = Allocator());
+  Deque(size_t n, const T& val, const Allocator& alloc = Allocator());
   ~Deque();
 
   Deque& operator=(const Deque& deque);
+  Deque& operator=(Deque&& deque) noexcept(kIsNothrowMoveAssignable);
 
   T& operator[](size_t idx);
   const T& operator[](size_t idx) const;
@@ -22,11 +59,25 @@ public:
   const T& at(size_t idx) const;
 
   void push_back(const T& val);
+  void push_back(T&& val);
   void push_front(const T& val);
+  void push_front(T&& val);
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  template <typename... Args>
+  T& emplace_front(Args&&... args);
   void pop_back();
   void pop_front();
 
+  template <typename InputIt>
+  void append(InputIt first, InputIt last);
+
   size_t size() const;
+  void shrink_to_fit();
+  DequeMemoryStats memory_stats() const;
+  void reset_memory_peak() { peak_blocks_ = allocated_blocks_; }
+  allocator_type get_allocator() const { return alloc_; }
+  void swap(Deque& deque);
 
   template <bool IsConst>
   class deque_iterator;
@@ -47,268 +98,643 @@ public:
   reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
 
   const_reverse_iterator rbegin() const noexcept { return crbegin(); }
-  const_reverse_iterator crbegin() const noexcept { return {cend()}; }
+  const_reverse_iterator crbegin() const noexcept {
+    return const_reverse_iterator(cend());
+  }
   const_reverse_iterator rend() const noexcept { return crend(); }
-  const_reverse_iterator crend() const noexcept { return {cbegin()}; }
+  const_reverse_iterator crend() const noexcept {
+    return const_reverse_iterator(cbegin());
+  }
 
-  void erase(iterator iter);
-  void insert(iterator iter, const T& val);
+  iterator erase(iterator iter);
+  iterator erase(iterator first, iterator last);
+  iterator insert(iterator iter, const T& val);
+  iterator insert(iterator iter, T&& val);
+  template <typename... Args>
+  iterator emplace(iterator iter, Args&&... args);
+  template <typename InputIt>
+  iterator insert(iterator iter, InputIt first, InputIt last);
 
 private:
-  static const size_t kBuffSz = 8;
-  std::vector<T*> map_;
-  std::pair<size_t, size_t> begin_{0, 0};
-  std::pair<size_t, size_t> end_{0, 0};
+  static const size_t kBuffSz = BuffSz;
+  static const size_t kShift = std::countr_zero(BuffSz);
+  static const size_t kMask = BuffSz - 1;
+  static const size_t kMaxFreeBlocks = 8;
+  static const size_t kMaxMapSlack = 8;
+  static const bool kIsNothrowMoveAssignable =
+      allocator_traits::propagate_on_container_move_assignment::value ||
+      allocator_traits::is_always_equal::value;
+  static const bool kIsTriviallyCopyable =
+      std::is_trivially_copyable_v<T> &&
+      !requires(allocator_type& alloc, T* ptr) { alloc.construct(ptr, *ptr); };
+  static const bool kIsTriviallyDestructible =
+      std::is_trivially_destructible_v<T> &&
+      !requires(allocator_type& alloc, T* ptr) { alloc.destroy(ptr); };
+  allocator_type alloc_;
+  std::vector<T*, map_allocator_type> map_{map_allocator_type(alloc_)};
+  std::vector<T*, map_allocator_type> free_blocks_{map_allocator_type(alloc_)};
+  size_t begin_{0};
+  size_t end_{0};
+  size_t allocated_blocks_{0};
+  size_t peak_blocks_{0};
+
+  static size_t node_of(size_t pos) { return pos >> kShift; }
+  static size_t offset_of(size_t pos) { return pos & kMask; }
+  T* slot(size_t pos) const { return map_[pos >> kShift] + (pos & kMask); }
+  bool is_map_sparse() const {
+    return map_.size() > kMaxMapSlack * (node_of(end_) - node_of(begin_) + 2);
+  }
 
-  void resize(size_t size);
-  void swap(Deque& deque);
-  void plus(std::pair<size_t, size_t>& pair);
-  void minus(std::pair<size_t, size_t>& pair);
+  T* acquire_block();
+  void deallocate_block(T* block);
+  void release_block(size_t node);
+  void ensure_block(size_t node);
+  void deallocate_blocks();
+  void reallocate_map(size_t nodes_to_add, bool add_at_front);
+  void swap_data(Deque& deque);
+  template <typename ForwardIt>
+  void prepend(ForwardIt first, ForwardIt last);
 };
 
-template <typename T>
-Deque<T>::Deque(size_t n, const T& val) {
-  resize(4 * (n + kBuffSz) / kBuffSz);
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>::Deque(size_t n, const T& val,
+                                   const Allocator& alloc)
+    : alloc_(alloc) {
+  reallocate_map(n / kBuffSz + 1, false);
   try {
-    for (size_t i = 0; i < n; ++i) {
-      new (map_[end_.first] + end_.second) T(val);
-      plus(end_);
+    if constexpr (kIsTriviallyCopyable) {
+      for (size_t node = node_of(begin_); node <= node_of(begin_ + n); ++node) {
+        ensure_block(node);
+      }
+      end_ = begin_ + n;
+      Fill(begin(), end(), val);
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        ensure_block(node_of(end_));
+        allocator_traits::construct(alloc_, slot(end_), val);
+        ++end_;
+      }
     }
   } catch (...) {
-    for (size_t j = 0; j < size(); ++j) {
-      operator[](j).~T();
-    }
-    for (T* item : map_) {
-      delete[] reinterpret_cast<char*>(item);
+    if constexpr (!kIsTriviallyDestructible) {
+      for (size_t j = 0; j < size(); ++j) {
+        allocator_traits::destroy(alloc_, &operator[](j));
+      }
     }
+    deallocate_blocks();
     this->end_ = this->begin_;
     throw;
   }
 }
 
-template <typename T>
-Deque<T>::Deque(size_t n) try : Deque(n, T()) {
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>::Deque(size_t n, const Allocator& alloc) try
+    : Deque(n, T(), alloc) {
 } catch (...) {
   throw;
 }
 
-template <typename T>
-Deque<T>::Deque(const Deque<T>& deque)
-    : map_(deque.map_.size()), begin_(deque.begin_), end_(deque.end_) {
-  for (size_t i = 0; i < map_.size(); ++i) {
-    map_[i] = reinterpret_cast<T*>(new char[kBuffSz * sizeof(T)]);
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>::Deque(const Deque& deque)
+    : Deque(deque, allocator_traits::select_on_container_copy_construction(
+                       deque.alloc_)) {}
+
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>::Deque(const Deque& deque, const Allocator& alloc)
+    : alloc_(alloc),
+      map_(deque.map_.size(), nullptr, map_allocator_type(alloc_)),
+      begin_(deque.begin_),
+      end_(deque.end_) {
+  if (!map_.empty()) {
+    free_blocks_.reserve(kMaxFreeBlocks);
   }
-  for (size_t i = 0; i < deque.size(); ++i) {
-    new (&operator[](i)) T(deque[i]);
+  size_t i = 0;
+  try {
+    for (size_t node = 0; node < map_.size(); ++node) {
+      if (deque.map_[node] != nullptr) {
+        map_[node] = acquire_block();
+      }
+    }
+    if constexpr (kIsTriviallyCopyable) {
+      Copy(deque.begin(), deque.end(), begin());
+    } else {
+      for (; i < deque.size(); ++i) {
+        allocator_traits::construct(alloc_, &operator[](i), deque[i]);
+      }
+    }
+  } catch (...) {
+    if constexpr (!kIsTriviallyDestructible) {
+      for (size_t j = 0; j < i; ++j) {
+        allocator_traits::destroy(alloc_, &operator[](j));
+      }
+    }
+    deallocate_blocks();
+    throw;
   }
 }
 
-template <typename T>
-Deque<T>::~Deque() {
-  for (size_t i = 0; i < size(); ++i) {
-    operator[](i).~T();
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>::Deque(Deque&& deque) noexcept
+    : alloc_(deque.alloc_),
+      map_(std::move(deque.map_)),
+      free_blocks_(std::move(deque.free_blocks_)),
+      begin_(deque.begin_),
+      end_(deque.end_),
+      allocated_blocks_(deque.allocated_blocks_),
+      peak_blocks_(deque.peak_blocks_) {
+  deque.map_.clear();
+  deque.free_blocks_.clear();
+  deque.begin_ = 0;
+  deque.end_ = 0;
+  deque.allocated_blocks_ = 0;
+  deque.peak_blocks_ = 0;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>::~Deque() {
+  if constexpr (!kIsTriviallyDestructible) {
+    for (size_t i = 0; i < size(); ++i) {
+      allocator_traits::destroy(alloc_, &operator[](i));
+    }
   }
-  for (T* item : map_) {
-    delete[] reinterpret_cast<char*>(item);
+  deallocate_blocks();
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>& Deque<T, Allocator, BuffSz>::operator=(
+    const Deque& deque) {
+  if (this == &deque) {
+    return *this;
   }
+  Deque tmp(deque,
+            allocator_traits::propagate_on_container_copy_assignment::value
+                ? deque.alloc_
+                : alloc_);
+  std::swap(alloc_, tmp.alloc_);
+  swap_data(tmp);
+  return *this;
 }
 
-template <typename T>
-Deque<T>& Deque<T>::operator=(const Deque& deque) {
-  Deque tmp(deque);
-  swap(tmp);
+template <typename T, typename Allocator, size_t BuffSz>
+Deque<T, Allocator, BuffSz>& Deque<T, Allocator, BuffSz>::operator=(
+    Deque&& deque) noexcept(kIsNothrowMoveAssignable) {
+  if (this == &deque) {
+    return *this;
+  }
+  if constexpr (!kIsNothrowMoveAssignable) {
+    if (alloc_ != deque.alloc_) {
+      Deque tmp(alloc_);
+      tmp.append(std::make_move_iterator(deque.begin()),
+                 std::make_move_iterator(deque.end()));
+      swap_data(tmp);
+      return *this;
+    }
+  }
+  Deque tmp(std::move(deque));
+  std::swap(alloc_, tmp.alloc_);
+  swap_data(tmp);
   return *this;
 }
 
-template <typename T>
-T& Deque<T>::operator[](size_t idx) {
-  return map_[begin_.first + (begin_.second + idx) / kBuffSz]
-             [(begin_.second + idx) % kBuffSz];
+template <typename T, typename Allocator, size_t BuffSz>
+T& Deque<T, Allocator, BuffSz>::operator[](size_t idx) {
+  return *slot(begin_ + idx);
 }
 
-template <typename T>
-const T& Deque<T>::operator[](size_t idx) const {
-  return map_[begin_.first + (begin_.second + idx) / kBuffSz]
-             [(begin_.second + idx) % kBuffSz];
+template <typename T, typename Allocator, size_t BuffSz>
+const T& Deque<T, Allocator, BuffSz>::operator[](size_t idx) const {
+  return *slot(begin_ + idx);
 }
 
-template <typename T>
-T& Deque<T>::at(size_t idx) {
+template <typename T, typename Allocator, size_t BuffSz>
+T& Deque<T, Allocator, BuffSz>::at(size_t idx) {
   if (idx >= size()) {
     throw std::out_of_range("criminal scum");
   }
   return operator[](idx);
 }
 
-template <typename T>
-const T& Deque<T>::at(size_t idx) const {
+template <typename T, typename Allocator, size_t BuffSz>
+const T& Deque<T, Allocator, BuffSz>::at(size_t idx) const {
   if (idx >= size()) {
     throw std::out_of_range("criminal scum");
   }
   return operator[](idx);
 }
 
-template <typename T>
-void Deque<T>::push_back(const T& val) {
-  if ((end_.first == map_.size() - 1 && end_.second == kBuffSz - 1) ||
-      size() == 0) {
-    try {
-      resize(2 * (map_.size() + 1));
-    } catch (...) {
-      throw;
-    }
-  }
-  new (map_[end_.first] + end_.second) T(val);
-  plus(end_);
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::push_back(const T& val) {
+  emplace_back(val);
 }
 
-template <typename T>
-void Deque<T>::push_front(const T& val) {
-  if ((begin_.first == 0 && begin_.second == 0) || size() == 0) {
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::push_back(T&& val) {
+  emplace_back(std::move(val));
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::push_front(const T& val) {
+  emplace_front(val);
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::push_front(T&& val) {
+  emplace_front(std::move(val));
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+template <typename... Args>
+T& Deque<T, Allocator, BuffSz>::emplace_back(Args&&... args) {
+  if (map_.empty() || end_ + 1 == (map_.size() << kShift) ||
+      (offset_of(end_) == 0 && is_map_sparse())) {
+    reallocate_map(1, false);
+  }
+  ensure_block(node_of(end_));
+  T* item = slot(end_);
+  allocator_traits::construct(alloc_, item, std::forward<Args>(args)...);
+  ++end_;
+  return *item;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+template <typename... Args>
+T& Deque<T, Allocator, BuffSz>::emplace_front(Args&&... args) {
+  if (map_.empty() || begin_ == 0 ||
+      (offset_of(begin_) == 0 && is_map_sparse())) {
+    reallocate_map(1, true);
+  }
+  ensure_block(node_of(begin_ - 1));
+  T* item = slot(begin_ - 1);
+  allocator_traits::construct(alloc_, item, std::forward<Args>(args)...);
+  --begin_;
+  return *item;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+template <typename InputIt>
+void Deque<T, Allocator, BuffSz>::append(InputIt first, InputIt last) {
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (!std::is_base_of_v<std::forward_iterator_tag, category>) {
+    for (; first != last; ++first) {
+      emplace_back(*first);
+    }
+  } else {
+    size_t count = std::distance(first, last);
+    if (count == 0) {
+      return;
+    }
+    size_t nodes_to_add = node_of(offset_of(end_) + count);
+    if (map_.empty() || node_of(end_) + nodes_to_add >= map_.size()) {
+      reallocate_map(nodes_to_add, false);
+    }
+    for (size_t cur = node_of(end_); cur <= node_of(end_ + count - 1); ++cur) {
+      ensure_block(cur);
+    }
+    size_t old_end = end_;
     try {
-      resize(2 * (map_.size() + 1));
+      for (; first != last; ++first) {
+        allocator_traits::construct(alloc_, slot(end_), *first);
+        ++end_;
+      }
     } catch (...) {
+      while (end_ != old_end) {
+        --end_;
+        allocator_traits::destroy(alloc_, slot(end_));
+      }
       throw;
     }
   }
-  minus(begin_);
-  new (map_[begin_.first] + begin_.second) T(val);
 }
 
-template <typename T>
-void Deque<T>::pop_back() {
-  operator[](size() - 1).~T();
-  minus(end_);
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::pop_back() {
+  allocator_traits::destroy(alloc_, &operator[](size() - 1));
+  if (offset_of(end_) == 0 && node_of(end_) != node_of(begin_)) {
+    release_block(node_of(end_));
+  }
+  --end_;
 }
 
-template <typename T>
-void Deque<T>::pop_front() {
-  operator[](0).~T();
-  plus(begin_);
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::pop_front() {
+  allocator_traits::destroy(alloc_, &operator[](0));
+  ++begin_;
+  if (offset_of(begin_) == 0) {
+    release_block(node_of(begin_) - 1);
+  }
 }
 
-template <typename T>
-size_t Deque<T>::size() const {
-  return (kBuffSz - begin_.second) + (end_.second) +
-         kBuffSz * (end_.first - begin_.first - 1);
+template <typename T, typename Allocator, size_t BuffSz>
+size_t Deque<T, Allocator, BuffSz>::size() const {
+  return end_ - begin_;
 }
 
-template <typename T>
-typename Deque<T>::iterator Deque<T>::begin() {
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::begin() {
   if (map_.empty()) {
-    return {nullptr, nullptr, nullptr, nullptr};
+    return {nullptr, nullptr, nullptr};
   }
-  return {*(map_.data() + begin_.first) + begin_.second,
-          *(map_.data() + begin_.first),
-          *(map_.data() + begin_.first) + kBuffSz, map_.data() + begin_.first};
+  return {slot(begin_), map_[node_of(begin_)], map_.data() + node_of(begin_)};
 }
 
-template <typename T>
-typename Deque<T>::iterator Deque<T>::end() {
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::end() {
   if (map_.empty()) {
-    return {nullptr, nullptr, nullptr, nullptr};
+    return {nullptr, nullptr, nullptr};
   }
-  return {*(map_.data() + end_.first) + end_.second,
-          *(map_.data() + end_.first), *(map_.data() + end_.first) + kBuffSz,
-          map_.data() + end_.first};
+  return {slot(end_), map_[node_of(end_)], map_.data() + node_of(end_)};
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cbegin() const {
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::const_iterator
+Deque<T, Allocator, BuffSz>::cbegin() const {
   if (map_.empty()) {
-    return {nullptr, nullptr, nullptr, nullptr};
+    return {nullptr, nullptr, nullptr};
   }
-  return {*(map_.data() + begin_.first) + begin_.second,
-          *(map_.data() + begin_.first),
-          *(map_.data() + begin_.first) + kBuffSz, map_.data() + begin_.first};
+  return {slot(begin_), map_[node_of(begin_)], map_.data() + node_of(begin_)};
 }
 
-template <typename T>
-typename Deque<T>::const_iterator Deque<T>::cend() const {
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::const_iterator
+Deque<T, Allocator, BuffSz>::cend() const {
   if (map_.empty()) {
-    return {nullptr, nullptr, nullptr, nullptr};
+    return {nullptr, nullptr, nullptr};
   }
-  return {*(map_.data() + end_.first) + end_.second,
-          *(map_.data() + end_.first), *(map_.data() + end_.first) + kBuffSz,
-          map_.data() + end_.first};
+  return {slot(end_), map_[node_of(end_)], map_.data() + node_of(end_)};
 }
 
-template <typename T>
-void Deque<T>::erase(iterator iter) {
-  for (iterator i = iter; i < end() - 1; ++i) {
-    *(i) = *(i + 1);
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::erase(iterator iter) {
+  return erase(iter, iter + 1);
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::erase(iterator first, iterator last) {
+  size_t idx = first - begin();
+  size_t count = last - first;
+  if (count == 0) {
+    return first;
+  }
+  if (idx < size() - idx - count) {
+    std::move_backward(begin(), first, last);
+    for (size_t i = 0; i < count; ++i) {
+      pop_front();
+    }
+  } else {
+    std::move(last, end(), first);
+    for (size_t i = 0; i < count; ++i) {
+      pop_back();
+    }
   }
-  pop_back();
+  return begin() + idx;
 }
 
-template <typename T>
-void Deque<T>::insert(iterator iter, const T& val) {
-  T tmp(val);
-  for (iterator i = iter; i < end(); ++i) {
-    std::swap(*(i), tmp);
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::insert(iterator iter, const T& val) {
+  return emplace(iter, val);
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::insert(iterator iter, T&& val) {
+  return emplace(iter, std::move(val));
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+template <typename... Args>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::emplace(iterator iter, Args&&... args) {
+  size_t idx = iter - begin();
+  if (idx == size()) {
+    emplace_back(std::forward<Args>(args)...);
+    return end() - 1;
+  }
+  if (idx == 0) {
+    emplace_front(std::forward<Args>(args)...);
+    return begin();
   }
-  push_back(tmp);
+  T tmp(std::forward<Args>(args)...);
+  if (idx < size() / 2) {
+    emplace_front(std::move(operator[](0)));
+    std::move(begin() + 2, begin() + idx + 1, begin() + 1);
+  } else {
+    emplace_back(std::move(operator[](size() - 1)));
+    std::move_backward(begin() + idx, end() - 2, end() - 1);
+  }
+  operator[](idx) = std::move(tmp);
+  return begin() + idx;
 }
 
-template <typename T>
-void Deque<T>::resize(size_t size) {
-  if (size <= map_.size()) {
+template <typename T, typename Allocator, size_t BuffSz>
+T* Deque<T, Allocator, BuffSz>::acquire_block() {
+  if (free_blocks_.empty()) {
+    T* block = allocator_traits::allocate(alloc_, kBuffSz);
+    ++allocated_blocks_;
+    peak_blocks_ = std::max(peak_blocks_, allocated_blocks_);
+    return block;
+  }
+  T* block = free_blocks_.back();
+  free_blocks_.pop_back();
+  return block;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::deallocate_block(T* block) {
+  allocator_traits::deallocate(alloc_, block, kBuffSz);
+  --allocated_blocks_;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::release_block(size_t node) {
+  if (map_[node] == nullptr) {
     return;
   }
-  std::vector<T*> new_map(size);
-  size_t shift = (size - map_.size()) / 2;
-  size_t i_mem = 0;
+  if (free_blocks_.size() < free_blocks_.capacity()) {
+    free_blocks_.push_back(map_[node]);
+  } else {
+    deallocate_block(map_[node]);
+  }
+  map_[node] = nullptr;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::ensure_block(size_t node) {
+  if (map_[node] == nullptr) {
+    map_[node] = acquire_block();
+  }
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::deallocate_blocks() {
+  for (T* item : map_) {
+    if (item != nullptr) {
+      deallocate_block(item);
+    }
+  }
+  for (T* item : free_blocks_) {
+    deallocate_block(item);
+  }
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::shrink_to_fit() {
+  for (T* item : free_blocks_) {
+    deallocate_block(item);
+  }
+  std::vector<T*, map_allocator_type>(map_allocator_type(alloc_))
+      .swap(free_blocks_);
+  if (begin_ == end_) {
+    deallocate_blocks();
+    std::vector<T*, map_allocator_type>(map_allocator_type(alloc_)).swap(map_);
+    begin_ = 0;
+    end_ = 0;
+    return;
+  }
+  size_t first_node = node_of(begin_);
+  size_t last_node = node_of(end_ - 1);
+  for (size_t node = 0; node < map_.size(); ++node) {
+    if ((node < first_node || node > last_node) && map_[node] != nullptr) {
+      deallocate_block(map_[node]);
+      map_[node] = nullptr;
+    }
+  }
+  std::vector<T*, map_allocator_type> new_map(
+      map_.begin() + first_node, map_.begin() + node_of(end_) + 1,
+      map_allocator_type(alloc_));
+  std::swap(map_, new_map);
+  begin_ -= first_node << kShift;
+  end_ -= first_node << kShift;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+DequeMemoryStats Deque<T, Allocator, BuffSz>::memory_stats() const {
+  return {size(),
+          allocated_blocks_,
+          free_blocks_.size(),
+          peak_blocks_,
+          map_.size(),
+          allocated_blocks_ * kBuffSz * sizeof(T) +
+              (map_.capacity() + free_blocks_.capacity()) * sizeof(T*)};
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+template <typename InputIt>
+typename Deque<T, Allocator, BuffSz>::iterator
+Deque<T, Allocator, BuffSz>::insert(iterator iter, InputIt first,
+                                    InputIt last) {
+  size_t idx = iter - begin();
+  size_t old_size = size();
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+    if (idx < old_size / 2) {
+      prepend(first, last);
+      size_t count = size() - old_size;
+      std::rotate(begin(), begin() + count, begin() + count + idx);
+      return begin() + idx;
+    }
+  }
+  append(first, last);
+  std::rotate(begin() + idx, begin() + old_size, end());
+  return begin() + idx;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+template <typename ForwardIt>
+void Deque<T, Allocator, BuffSz>::prepend(ForwardIt first, ForwardIt last) {
+  size_t count = std::distance(first, last);
+  if (count == 0) {
+    return;
+  }
+  size_t nodes_to_add = node_of(kMask - offset_of(begin_) + count);
+  if (map_.empty() || node_of(begin_) < nodes_to_add) {
+    reallocate_map(nodes_to_add, true);
+  }
+  size_t new_begin = begin_ - count;
+  for (size_t cur = node_of(new_begin); cur <= node_of(begin_ - 1); ++cur) {
+    ensure_block(cur);
+  }
+  size_t cur = new_begin;
   try {
-    for (; i_mem < size; ++i_mem) {
-      if (i_mem - shift < map_.size()) {
-        new_map[i_mem] = map_[i_mem - shift];
-      } else {
-        new_map[i_mem] = reinterpret_cast<T*>(new char[kBuffSz * sizeof(T)]);
-      }
+    for (; first != last; ++first) {
+      allocator_traits::construct(alloc_, slot(cur), *first);
+      ++cur;
     }
   } catch (...) {
-    for (size_t j = 0; j < i_mem; ++j) {
-      if (j - shift > map_.size()) {
-        delete[] reinterpret_cast<char*>(new_map[i_mem]);
-      }
+    while (cur != new_begin) {
+      --cur;
+      allocator_traits::destroy(alloc_, slot(cur));
     }
     throw;
   }
-  begin_.first += shift;
-  end_.first += shift;
-  std::swap(map_, new_map);
+  begin_ = new_begin;
+}
+
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::reallocate_map(size_t nodes_to_add,
+                                                 bool add_at_front) {
+  free_blocks_.reserve(kMaxFreeBlocks);
+  size_t old_num_nodes = map_.empty() ? 1 : node_of(end_) - node_of(begin_) + 1;
+  size_t new_num_nodes = old_num_nodes + nodes_to_add;
+  size_t new_start = 0;
+  if (map_.size() >= 2 * new_num_nodes &&
+      map_.size() <= kMaxMapSlack * new_num_nodes) {
+    new_start = (map_.size() - new_num_nodes) / 2 +
+                (add_at_front ? nodes_to_add : 0);
+    if (new_start < node_of(begin_)) {
+      std::rotate(map_.begin(), map_.begin() + (node_of(begin_) - new_start),
+                  map_.end());
+    } else {
+      std::rotate(map_.begin(), map_.end() - (new_start - node_of(begin_)),
+                  map_.end());
+    }
+  } else {
+    size_t new_size = 2 * new_num_nodes + 2;
+    std::vector<T*, map_allocator_type> new_map(new_size, nullptr,
+                                                map_allocator_type(alloc_));
+    new_start = (new_size - new_num_nodes) / 2 +
+                (add_at_front ? nodes_to_add : 0);
+    if (!map_.empty()) {
+      auto first_node = map_.begin() + node_of(begin_);
+      auto last_node = map_.begin() + node_of(end_) + 1;
+      std::copy(first_node, last_node, new_map.begin() + new_start);
+      std::fill(first_node, last_node, nullptr);
+      for (size_t node = 0; node < map_.size(); ++node) {
+        release_block(node);
+      }
+    }
+    std::swap(map_, new_map);
+  }
+  size_t len = end_ - begin_;
+  begin_ = (new_start << kShift) + offset_of(begin_);
+  end_ = begin_ + len;
 }
 
-template <typename T>
-void Deque<T>::swap(Deque<T>& deque) {
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::swap_data(Deque& deque) {
   std::swap(map_, deque.map_);
+  std::swap(free_blocks_, deque.free_blocks_);
   std::swap(begin_, deque.begin_);
   std::swap(end_, deque.end_);
+  std::swap(allocated_blocks_, deque.allocated_blocks_);
+  std::swap(peak_blocks_, deque.peak_blocks_);
 }
 
-template <typename T>
-void Deque<T>::plus(std::pair<size_t, size_t>& pair) {
-  if (pair.second == kBuffSz - 1) {
-    pair.second = 0;
-    ++pair.first;
-  } else {
-    ++pair.second;
-  }
-}
-
-template <typename T>
-void Deque<T>::minus(std::pair<size_t, size_t>& pair) {
-  if (pair.second == 0) {
-    pair.second = kBuffSz - 1;
-    --pair.first;
-  } else {
-    --pair.second;
+template <typename T, typename Allocator, size_t BuffSz>
+void Deque<T, Allocator, BuffSz>::swap(Deque& deque) {
+  if (allocator_traits::propagate_on_container_swap::value) {
+    std::swap(alloc_, deque.alloc_);
   }
+  swap_data(deque);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-class Deque<T>::deque_iterator {
+class Deque<T, Allocator, BuffSz>::deque_iterator {
 public:
   using value_type = std::conditional_t<IsConst, const T, T>;
   using difference_type = std::ptrdiff_t;
@@ -317,12 +743,15 @@ public:
   using iterator_category = std::random_access_iterator_tag;
   using double_pointer = std::conditional_t<IsConst, pointer const*, pointer*>;
 
-  deque_iterator(pointer cur, pointer first, pointer last, double_pointer node)
-      : cur_(cur), first_(first), last_(last), node_(node) {}
+  deque_iterator(pointer cur, pointer first, double_pointer node)
+      : cur_(cur), first_(first), node_(node) {}
   operator const_iterator() const { return const_iterator(*this); }
 
-  reference operator*() { return *cur_; }
-  pointer operator->() { return cur_; }
+  reference operator*() const { return *cur_; }
+  pointer operator->() const { return cur_; }
+
+  pointer segment_begin() const { return cur_; }
+  pointer segment_end() const { return first_ + kBuffSz; }
 
   deque_iterator& operator+=(difference_type n);
   deque_iterator& operator-=(difference_type n);
@@ -342,21 +771,20 @@ public:
 private:
   pointer cur_;
   pointer first_;
-  pointer last_;
   double_pointer node_;
 
   void set_node(double_pointer new_node) {
     node_ = new_node;
     first_ = *new_node;
-    last_ = first_ + kBuffSz;
   }
 };
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>&
-Deque<T>::deque_iterator<IsConst>::operator+=(difference_type n) {
-  if (cur_ == nullptr && first_ == nullptr && last_ == nullptr) {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>&
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator+=(
+    difference_type n) {
+  if (node_ == nullptr) {
     return *this;
   }
   std::ptrdiff_t shift = n + (cur_ - first_);
@@ -364,83 +792,85 @@ Deque<T>::deque_iterator<IsConst>::operator+=(difference_type n) {
     cur_ += n;
     return *this;
   }
-  std::ptrdiff_t node_shift = shift / std::ptrdiff_t(kBuffSz);
-  if (shift <= 0) {
-    node_shift = -((-shift - 1) / std::ptrdiff_t(kBuffSz)) - 1;
-  }
-  set_node(node_ + node_shift);
-  cur_ = first_ + (shift - node_shift * kBuffSz);
+  set_node(node_ + (shift >> kShift));
+  cur_ = first_ + (shift & kMask);
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>&
-Deque<T>::deque_iterator<IsConst>::operator-=(difference_type n) {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>&
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator-=(
+    difference_type n) {
   return *this += -n;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>&
-Deque<T>::deque_iterator<IsConst>::operator++() {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>&
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator++() {
   *this += 1;
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>&
-Deque<T>::deque_iterator<IsConst>::operator--() {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>&
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator--() {
   *this -= 1;
   return *this;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>
-Deque<T>::deque_iterator<IsConst>::operator++(int) {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator++(int) {
   deque_iterator tmp(*this);
   *this += 1;
   return tmp;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>
-Deque<T>::deque_iterator<IsConst>::operator--(int) {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator--(int) {
   deque_iterator tmp(*this);
   *this -= 1;
   return tmp;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>
-Deque<T>::deque_iterator<IsConst>::operator+(difference_type n) const {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator+(
+    difference_type n) const {
   deque_iterator tmp(*this);
   tmp += n;
   return tmp;
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>
-Deque<T>::deque_iterator<IsConst>::operator-(difference_type n) const {
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<IsConst>
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator-(
+    difference_type n) const {
   return *this + (-n);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-typename Deque<T>::template deque_iterator<IsConst>::difference_type
-Deque<T>::deque_iterator<IsConst>::operator-(const deque_iterator& iter) const {
-  return (node_ - iter.node_) * kBuffSz + (cur_ - first_) -
+typename Deque<T, Allocator, BuffSz>::template deque_iterator<
+    IsConst>::difference_type
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator-(
+    const deque_iterator& iter) const {
+  return (node_ - iter.node_) * std::ptrdiff_t(kBuffSz) + (cur_ - first_) -
          (iter.cur_ - iter.first_);
 }
 
-template <typename T>
+template <typename T, typename Allocator, size_t BuffSz>
 template <bool IsConst>
-std::strong_ordering Deque<T>::deque_iterator<IsConst>::operator<=>(
+std::strong_ordering
+Deque<T, Allocator, BuffSz>::deque_iterator<IsConst>::operator<=>(
     const deque_iterator& iter) const {
   if (node_ < iter.node_) {
     return std::strong_ordering::less;
@@ -455,4 +885,68 @@ std::strong_ordering Deque<T>::deque_iterator<IsConst>::operator<=>(
     return std::strong_ordering::greater;
   }
   return std::strong_ordering::equal;
-}
\ No newline at end of file
+}
+
+template <typename Iterator>
+concept SegmentedIterator = requires(const Iterator iter) {
+  iter.segment_begin();
+  iter.segment_end();
+};
+
+template <SegmentedIterator Iterator, typename Function>
+void ForEachSegment(Iterator first, Iterator last, Function function) {
+  while (first != last) {
+    auto seg_begin = first.segment_begin();
+    auto seg_len = std::min(last - first, first.segment_end() - seg_begin);
+    function(seg_begin, seg_begin + seg_len);
+    first += seg_len;
+  }
+}
+
+template <SegmentedIterator InputIt, typename OutputIt>
+OutputIt Copy(InputIt first, InputIt last, OutputIt out) {
+  ForEachSegment(first, last, [&out](auto seg_begin, auto seg_end) {
+    if constexpr (SegmentedIterator<OutputIt>) {
+      while (seg_begin != seg_end) {
+        auto out_begin = out.segment_begin();
+        auto seg_len = std::min(seg_end - seg_begin,
+                                out.segment_end() - out_begin);
+        std::copy(seg_begin, seg_begin + seg_len, out_begin);
+        seg_begin += seg_len;
+        out += seg_len;
+      }
+    } else {
+      out = std::copy(seg_begin, seg_end, out);
+    }
+  });
+  return out;
+}
+
+template <SegmentedIterator Iterator, typename T>
+void Fill(Iterator first, Iterator last, const T& val) {
+  ForEachSegment(first, last, [&val](auto seg_begin, auto seg_end) {
+    std::fill(seg_begin, seg_end, val);
+  });
+}
+
+template <SegmentedIterator Iterator, typename T>
+Iterator Find(Iterator first, Iterator last, const T& val) {
+  while (first != last) {
+    auto seg_begin = first.segment_begin();
+    auto seg_len = std::min(last - first, first.segment_end() - seg_begin);
+    auto found = std::find(seg_begin, seg_begin + seg_len, val);
+    if (found != seg_begin + seg_len) {
+      return first + (found - seg_begin);
+    }
+    first += seg_len;
+  }
+  return last;
+}
+
+template <SegmentedIterator Iterator, typename T>
+T Accumulate(Iterator first, Iterator last, T init) {
+  ForEachSegment(first, last, [&init](auto seg_begin, auto seg_end) {
+    init = std::accumulate(seg_begin, seg_end, std::move(init));
+  });
+  return init;
+}
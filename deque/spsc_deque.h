@@ -0,0 +1,164 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "deque.h"
+
+template <typename T, size_t BuffSz = DefaultBuffSz<T>()>
+class SpscDeque {
+public:
+  SpscDeque();
+  SpscDeque(size_t max_size);
+  SpscDeque(const SpscDeque& deque) = delete;
+  SpscDeque& operator=(const SpscDeque& deque) = delete;
+  ~SpscDeque();
+
+  bool try_push_back(const T& val);
+  bool try_push_back(T&& val);
+  template <typename... Args>
+  bool try_emplace_back(Args&&... args);
+  bool try_pop_front(T& val);
+
+  size_t size() const;
+  bool empty() const;
+  size_t max_size() const { return max_size_; }
+
+private:
+  static const size_t kBuffSz = BuffSz;
+
+  struct Block {
+    std::atomic<Block*> next{nullptr};
+    alignas(T) char storage[kBuffSz * sizeof(T)];
+
+    T* slots() { return reinterpret_cast<T*>(storage); }
+  };
+
+  alignas(kCacheLineSz) std::atomic<size_t> head_{0};
+  Block* head_block_;
+  size_t cached_tail_{0};
+
+  alignas(kCacheLineSz) std::atomic<size_t> tail_{0};
+  Block* tail_block_;
+  size_t cached_head_{0};
+  const size_t max_size_;
+
+  alignas(kCacheLineSz) std::atomic<Block*> spare_block_{nullptr};
+
+  Block* acquire_block();
+  void release_block(Block* block);
+};
+
+template <typename T, size_t BuffSz>
+SpscDeque<T, BuffSz>::SpscDeque() : SpscDeque(SIZE_MAX) {}
+
+template <typename T, size_t BuffSz>
+SpscDeque<T, BuffSz>::SpscDeque(size_t max_size)
+    : head_block_(new Block), tail_block_(head_block_), max_size_(max_size) {}
+
+template <typename T, size_t BuffSz>
+SpscDeque<T, BuffSz>::~SpscDeque() {
+  size_t tail = tail_.load(std::memory_order_acquire);
+  for (size_t head = head_.load(std::memory_order_relaxed); head != tail;
+       ++head) {
+    if (head % kBuffSz == 0 && head != 0) {
+      Block* next = head_block_->next.load(std::memory_order_relaxed);
+      delete head_block_;
+      head_block_ = next;
+    }
+    head_block_->slots()[head % kBuffSz].~T();
+  }
+  while (head_block_ != nullptr) {
+    Block* next = head_block_->next.load(std::memory_order_relaxed);
+    delete head_block_;
+    head_block_ = next;
+  }
+  delete spare_block_.load(std::memory_order_relaxed);
+}
+
+template <typename T, size_t BuffSz>
+typename SpscDeque<T, BuffSz>::Block* SpscDeque<T, BuffSz>::acquire_block() {
+  Block* block = spare_block_.exchange(nullptr, std::memory_order_acquire);
+  if (block == nullptr) {
+    return new Block;
+  }
+  block->next.store(nullptr, std::memory_order_relaxed);
+  return block;
+}
+
+template <typename T, size_t BuffSz>
+void SpscDeque<T, BuffSz>::release_block(Block* block) {
+  delete spare_block_.exchange(block, std::memory_order_acq_rel);
+}
+
+template <typename T, size_t BuffSz>
+bool SpscDeque<T, BuffSz>::try_push_back(const T& val) {
+  return try_emplace_back(val);
+}
+
+template <typename T, size_t BuffSz>
+bool SpscDeque<T, BuffSz>::try_push_back(T&& val) {
+  return try_emplace_back(std::move(val));
+}
+
+template <typename T, size_t BuffSz>
+template <typename... Args>
+bool SpscDeque<T, BuffSz>::try_emplace_back(Args&&... args) {
+  size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - cached_head_ >= max_size_) {
+    cached_head_ = head_.load(std::memory_order_acquire);
+    if (tail - cached_head_ >= max_size_) {
+      return false;
+    }
+  }
+  if (tail % kBuffSz == 0 && tail != 0) {
+    Block* block = acquire_block();
+    try {
+      new (block->slots()) T(std::forward<Args>(args)...);
+    } catch (...) {
+      release_block(block);
+      throw;
+    }
+    tail_block_->next.store(block, std::memory_order_relaxed);
+    tail_block_ = block;
+  } else {
+    new (tail_block_->slots() + tail % kBuffSz) T(std::forward<Args>(args)...);
+  }
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, size_t BuffSz>
+bool SpscDeque<T, BuffSz>::try_pop_front(T& val) {
+  size_t head = head_.load(std::memory_order_relaxed);
+  if (head == cached_tail_) {
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    if (head == cached_tail_) {
+      return false;
+    }
+  }
+  bool is_block_end = head % kBuffSz == 0 && head != 0;
+  Block* block = is_block_end
+                     ? head_block_->next.load(std::memory_order_relaxed)
+                     : head_block_;
+  T* slot = block->slots() + head % kBuffSz;
+  val = std::move(*slot);
+  slot->~T();
+  if (is_block_end) {
+    release_block(head_block_);
+    head_block_ = block;
+  }
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, size_t BuffSz>
+size_t SpscDeque<T, BuffSz>::size() const {
+  size_t head = head_.load(std::memory_order_acquire);
+  return tail_.load(std::memory_order_acquire) - head;
+}
+
+template <typename T, size_t BuffSz>
+bool SpscDeque<T, BuffSz>::empty() const {
+  return size() == 0;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "deque.h"
+
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "WorkStealingDeque requires trivially copyable elements");
+
+public:
+  WorkStealingDeque(size_t capacity = kInitialCapacity);
+  WorkStealingDeque(const WorkStealingDeque& deque) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque& deque) = delete;
+
+  void push_back(const T& val);
+  bool try_pop_back(T& val);
+  bool try_steal(T& val);
+
+  size_t size() const;
+  bool empty() const;
+
+private:
+  static const size_t kInitialCapacity = 64;
+
+  struct Buffer {
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+
+    Buffer(size_t capacity)
+        : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {}
+
+    size_t capacity() const { return mask + 1; }
+    T get(int64_t idx) const {
+      return slots[idx & mask].load(std::memory_order_relaxed);
+    }
+    void put(int64_t idx, const T& val) {
+      slots[idx & mask].store(val, std::memory_order_relaxed);
+    }
+  };
+
+  alignas(kCacheLineSz) std::atomic<int64_t> top_{0};
+  alignas(kCacheLineSz) std::atomic<int64_t> bottom_{0};
+  alignas(kCacheLineSz) std::atomic<Buffer*> buffer_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  Buffer* grow(Buffer* buffer, int64_t top, int64_t bottom);
+};
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(size_t capacity) {
+  size_t pow2_capacity = 1;
+  while (pow2_capacity < capacity) {
+    pow2_capacity *= 2;
+  }
+  buffers_.emplace_back(new Buffer(pow2_capacity));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+template <typename T>
+typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::grow(
+    Buffer* buffer, int64_t top, int64_t bottom) {
+  buffers_.emplace_back(new Buffer(buffer->capacity() * 2));
+  Buffer* new_buffer = buffers_.back().get();
+  for (int64_t idx = top; idx < bottom; ++idx) {
+    new_buffer->put(idx, buffer->get(idx));
+  }
+  buffer_.store(new_buffer, std::memory_order_release);
+  return new_buffer;
+}
+
+template <typename T>
+void WorkStealingDeque<T>::push_back(const T& val) {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  int64_t top = top_.load(std::memory_order_acquire);
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  if (bottom - top > static_cast<int64_t>(buffer->mask)) {
+    buffer = grow(buffer, top, bottom);
+  }
+  buffer->put(bottom, val);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::try_pop_back(T& val) {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return false;
+  }
+  val = buffer->get(bottom);
+  if (top == bottom) {
+    bool is_won = top_.compare_exchange_strong(top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return is_won;
+  }
+  return true;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::try_steal(T& val) {
+  int64_t top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return false;
+  }
+  Buffer* buffer = buffer_.load(std::memory_order_acquire);
+  T stolen = buffer->get(top);
+  if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                    std::memory_order_relaxed)) {
+    return false;
+  }
+  val = stolen;
+  return true;
+}
+
+template <typename T>
+size_t WorkStealingDeque<T>::size() const {
+  int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  int64_t top = top_.load(std::memory_order_relaxed);
+  return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::empty() const {
+  return size() == 0;
+}
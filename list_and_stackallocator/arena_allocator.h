@@ -0,0 +1,121 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+
+#include "list_stackallocator.h"
+
+template <auto N>
+class ArenaStorage {
+public:
+  ArenaStorage() = default;
+  ArenaStorage(const ArenaStorage<N>& other) = delete;
+  ArenaStorage operator=(const ArenaStorage<N>& other) = delete;
+  ~ArenaStorage();
+
+  void* allocate(std::size_t bytes, std::size_t alignment);
+  void release();
+
+  std::size_t bytes_used() const { return bytes_used_; }
+  std::size_t bytes_wasted() const { return bytes_wasted_; }
+
+private:
+  struct Chunk {
+    Chunk* prev;
+    std::size_t size;
+  };
+
+  static const std::size_t kMinChunkSz = 1024;
+  static const std::size_t kFirstChunkSz =
+      2 * N > kMinChunkSz ? 2 * N : kMinChunkSz;
+
+  StackStorage<N> inline_storage_;
+  Chunk* chunks_{nullptr};
+  char* cur_{inline_storage_.storage};
+  std::size_t left_{N};
+  std::size_t next_chunk_sz_{kFirstChunkSz};
+  std::size_t bytes_used_{0};
+  std::size_t bytes_wasted_{0};
+
+  void add_chunk(std::size_t min_size);
+};
+
+template <auto N>
+ArenaStorage<N>::~ArenaStorage() {
+  release();
+}
+
+template <auto N>
+void ArenaStorage<N>::add_chunk(std::size_t min_size) {
+  std::size_t size = next_chunk_sz_ > min_size ? next_chunk_sz_ : min_size;
+  auto* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+  chunk->prev = chunks_;
+  chunk->size = size;
+  chunks_ = chunk;
+  cur_ = reinterpret_cast<char*>(chunk + 1);
+  left_ = size;
+  next_chunk_sz_ = 2 * size;
+}
+
+template <auto N>
+void* ArenaStorage<N>::allocate(std::size_t bytes, std::size_t alignment) {
+  void* ptr = cur_;
+  std::size_t space_left = left_;
+  if (std::align(alignment, bytes, ptr, space_left) == nullptr) {
+    add_chunk(bytes + alignment);
+    ptr = cur_;
+    space_left = left_;
+    std::align(alignment, bytes, ptr, space_left);
+  }
+  bytes_wasted_ += left_ - space_left;
+  bytes_used_ += bytes;
+  cur_ = static_cast<char*>(ptr) + bytes;
+  left_ = space_left - bytes;
+  if (chunks_ == nullptr) {
+    inline_storage_.top = cur_ - inline_storage_.storage;
+  }
+  return ptr;
+}
+
+template <auto N>
+void ArenaStorage<N>::release() {
+  while (chunks_ != nullptr) {
+    Chunk* prev = chunks_->prev;
+    ::operator delete(chunks_);
+    chunks_ = prev;
+  }
+  inline_storage_.reset();
+  cur_ = inline_storage_.storage;
+  left_ = N;
+  next_chunk_sz_ = kFirstChunkSz;
+  bytes_used_ = 0;
+  bytes_wasted_ = 0;
+}
+
+template <typename T, auto N>
+struct ArenaAllocator {
+  using value_type = T;
+  using pointer = value_type*;
+
+  ArenaAllocator() = default;
+  ArenaAllocator(ArenaStorage<N>& storage) : storage(&storage) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U, N>& other) : storage(other.storage) {}
+
+  pointer allocate(std::size_t size) {
+    return static_cast<pointer>(
+        storage->allocate(sizeof(value_type) * size, alignof(value_type)));
+  }
+  void deallocate(T* /*unused*/, std::size_t /*unused*/) {}
+
+  bool operator==(const ArenaAllocator& other) const {
+    return storage == other.storage;
+  }
+
+  template <class U>
+  struct rebind {  // NOLINT
+    using other = ArenaAllocator<U, N>;
+  };
+
+  ArenaStorage<N>* storage{nullptr};
+};
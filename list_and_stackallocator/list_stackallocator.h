@@ -1,8 +1,14 @@
 #pragma once
+#include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <exception>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <utility>
+
+const unsigned char kPoisonByte = 0xDD;
 
 template <auto N>
 struct StackStorage {
@@ -12,10 +18,26 @@ struct StackStorage {
   StackStorage operator=(const StackStorage<N>& other) = delete;
   StackStorage operator=(const StackStorage<N>&& other) = delete;
   ~StackStorage() = default;
+
+  std::ptrdiff_t mark() const { return top; }
+  void rewind(std::ptrdiff_t mark);
+  void reset() { rewind(0); }
+
   char storage[N];
   std::ptrdiff_t top{0};
 };
 
+template <auto N>
+void StackStorage<N>::rewind(std::ptrdiff_t mark) {
+  assert(mark >= 0 && mark <= top);
+#ifndef NDEBUG
+  if (mark < top) {
+    std::memset(storage + mark, kPoisonByte, top - mark);
+  }
+#endif
+  top = mark;
+}
+
 template <typename T, auto N>
 struct StackAllocator {
   using value_type = T;
@@ -23,15 +45,11 @@ struct StackAllocator {
 
   StackAllocator() = default;
   StackAllocator(StackStorage<N>& storage) : storage(&storage) {}
-  StackAllocator(const StackAllocator& other)
-      : storage(other.storage), space_left(other.space_left) {}
+  StackAllocator(const StackAllocator& other) : storage(other.storage) {}
   template <typename U>
-  StackAllocator(const StackAllocator<U, N>& other)
-      : storage(other.storage), space_left(other.space_left) {}
+  StackAllocator(const StackAllocator<U, N>& other) : storage(other.storage) {}
   StackAllocator& operator=(const StackAllocator& other) {
-    auto copy(other);
-    std::swap(storage, copy.storage);
-    std::swap(space_left, copy.space_left);
+    storage = other.storage;
     return *this;
   }
 
@@ -48,17 +66,16 @@ struct StackAllocator {
   };
 
   StackStorage<N>* storage{nullptr};
-  std::size_t space_left{static_cast<size_t>(N) - storage->top};
 };
 
 template <typename T, auto N>
 auto StackAllocator<T, N>::allocate(std::size_t size) -> pointer {
   void* ptr = storage->storage + storage->top;
+  auto space_left = static_cast<std::size_t>(N - storage->top);
   if (std::align(alignof(value_type), sizeof(value_type) * size, ptr,
                  space_left) != nullptr) {
     auto result = reinterpret_cast<pointer>(ptr);
     ptr = reinterpret_cast<char*>(ptr) + sizeof(value_type) * size;
-    space_left -= sizeof(value_type) * size;
     storage->top = reinterpret_cast<char*>(ptr) - storage->storage;
     return result;
   }
@@ -98,6 +115,21 @@ public:
   void insert(const_iterator iter, const T& val);
   void erase(const_iterator iter);
 
+  void splice(const_iterator pos, List& list);
+  void splice(const_iterator pos, List& list, const_iterator iter);
+  void splice(const_iterator pos, List& list, const_iterator first,
+              const_iterator last);
+  void merge(List& list);
+  template <typename Compare>
+  void merge(List& list, Compare comp);
+  void sort();
+  template <typename Compare>
+  void sort(Compare comp);
+  void reverse();
+  size_t unique();
+  template <typename BinaryPredicate>
+  size_t unique(BinaryPredicate pred);
+
   size_t size() const { return sz_; }
   allocator_type get_allocator() const { return alloc_; }
 
@@ -105,11 +137,9 @@ public:
   iterator end();
 
   const_iterator begin() const { return cbegin(); }
-  const_iterator cbegin() const { return const_iterator(begin_, 0); }
+  const_iterator cbegin() const { return const_iterator(begin_); }
   const_iterator end() const { return cend(); }
-  const_iterator cend() const {
-    return const_iterator(end_, static_cast<std::ptrdiff_t>(sz_));
-  }
+  const_iterator cend() const { return const_iterator(end_); }
 
   reverse_iterator rbegin() noexcept {
     return std::make_reverse_iterator(end());
@@ -140,6 +170,13 @@ private:
   void create_node(Node* right, const T& val);
   void delete_node(Node* node);
 
+  void link_range(Node* pos, Node* first, Node* tail);
+  void unlink_range(Node* first, Node* last);
+  void transfer(Node* pos, List& list, Node* first, Node* last, size_t count);
+  void relink_chain(Node* head);
+  template <typename Compare>
+  static void merge_chains(Node*& left, Node*& right, Compare& comp);
+
   void clear();
 
   void swap(List& list);
@@ -235,13 +272,66 @@ void List<T, Allocator>::clear() {
   }
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::link_range(Node* pos, Node* first, Node* tail) {
+  Node* before = pos->prev;
+  first->prev = before;
+  if (before != nullptr) {
+    before->next = first;
+  } else {
+    begin_ = first;
+  }
+  tail->next = pos;
+  pos->prev = tail;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::unlink_range(Node* first, Node* last) {
+  Node* before = first->prev;
+  if (before != nullptr) {
+    before->next = last;
+  } else {
+    begin_ = last;
+  }
+  last->prev = before;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::transfer(Node* pos, List& list, Node* first,
+                                  Node* last, size_t count) {
+  if (first == last || pos == first || pos == last) {
+    return;
+  }
+  Node* tail = last->prev;
+  list.unlink_range(first, last);
+  link_range(pos, first, tail);
+  list.sz_ -= count;
+  sz_ += count;
+}
+
 template <typename T, typename Allocator>
 void List<T, Allocator>::swap(List<T, Allocator>& list) {
   std::swap(alloc_, list.alloc_);
-  std::swap(sub_node_, list.sub_node_);
-  std::swap(begin_, list.begin_);
-  std::swap(end_, list.end_);
-  std::swap(sz_, list.sz_);
+  Node* first = begin_;
+  Node* tail = end_->prev;
+  Node* list_first = list.begin_;
+  Node* list_tail = list.end_->prev;
+  size_t sz = sz_;
+  size_t list_sz = list.sz_;
+  begin_ = end_;
+  end_->prev = nullptr;
+  sz_ = 0;
+  list.begin_ = list.end_;
+  list.end_->prev = nullptr;
+  list.sz_ = 0;
+  if (list_sz != 0) {
+    link_range(end_, list_first, list_tail);
+  }
+  if (sz != 0) {
+    list.link_range(list.end_, first, tail);
+  }
+  sz_ = list_sz;
+  list.sz_ = sz;
 }
 
 template <typename T, typename Allocator>
@@ -332,14 +422,212 @@ void List<T, Allocator>::insert(List::const_iterator iter, const T& val) {
   create_node(iter.operator->(), val);
 }
 
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(List::const_iterator pos, List& list) {
+  if (&list == this || list.sz_ == 0) {
+    return;
+  }
+  transfer(pos.operator->(), list, list.begin_, list.end_, list.sz_);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(List::const_iterator pos, List& list,
+                                List::const_iterator iter) {
+  Node* node = iter.operator->();
+  transfer(pos.operator->(), list, node, node->next, &list == this ? 0 : 1);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::splice(List::const_iterator pos, List& list,
+                                List::const_iterator first,
+                                List::const_iterator last) {
+  Node* first_node = first.operator->();
+  Node* last_node = last.operator->();
+  size_t count = 0;
+  if (&list != this) {
+    for (Node* node = first_node; node != last_node; node = node->next) {
+      ++count;
+    }
+  }
+  transfer(pos.operator->(), list, first_node, last_node, count);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::merge(List& list) {
+  merge(list, std::less<>());
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::merge(List& list, Compare comp) {
+  if (&list == this) {
+    return;
+  }
+  Node* cur = begin_;
+  while (list.sz_ != 0) {
+    Node* first = list.begin_;
+    if (cur != end_ && !comp(first->val, cur->val)) {
+      cur = cur->next;
+      continue;
+    }
+    Node* last = first->next;
+    size_t count = 1;
+    while (last != list.end_ && (cur == end_ || comp(last->val, cur->val))) {
+      last = last->next;
+      ++count;
+    }
+    transfer(cur, list, first, last, count);
+  }
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::merge_chains(Node*& left, Node*& right,
+                                      Compare& comp) {
+  Node* head = nullptr;
+  Node** tail = &head;
+  try {
+    while (left != nullptr && right != nullptr) {
+      if (comp(right->val, left->val)) {
+        *tail = right;
+        right = right->next;
+      } else {
+        *tail = left;
+        left = left->next;
+      }
+      tail = &(*tail)->next;
+    }
+  } catch (...) {
+    *tail = left;
+    while (*tail != nullptr) {
+      tail = &(*tail)->next;
+    }
+    *tail = right;
+    left = head;
+    right = nullptr;
+    throw;
+  }
+  *tail = left != nullptr ? left : right;
+  left = head;
+  right = nullptr;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::relink_chain(Node* head) {
+  begin_ = head;
+  Node* prev = nullptr;
+  for (Node* node = head; node != nullptr; node = node->next) {
+    node->prev = prev;
+    prev = node;
+  }
+  prev->next = end_;
+  end_->prev = prev;
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::sort() {
+  sort(std::less<>());
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void List<T, Allocator>::sort(Compare comp) {
+  if (sz_ < 2) {
+    return;
+  }
+  static const size_t kMaxRuns = 64;
+  Node* runs[kMaxRuns]{};
+  Node* carry = nullptr;
+  Node* rest = begin_;
+  end_->prev->next = nullptr;
+  try {
+    while (rest != nullptr) {
+      carry = rest;
+      rest = rest->next;
+      carry->next = nullptr;
+      size_t rank = 0;
+      for (; runs[rank] != nullptr; ++rank) {
+        merge_chains(runs[rank], carry, comp);
+        std::swap(carry, runs[rank]);
+      }
+      std::swap(carry, runs[rank]);
+    }
+    for (size_t rank = 0; rank < kMaxRuns; ++rank) {
+      if (runs[rank] != nullptr) {
+        merge_chains(runs[rank], carry, comp);
+        std::swap(carry, runs[rank]);
+      }
+    }
+  } catch (...) {
+    Node* head = nullptr;
+    Node** tail = &head;
+    for (Node* chain : {carry, rest}) {
+      *tail = chain;
+      while (*tail != nullptr) {
+        tail = &(*tail)->next;
+      }
+    }
+    for (Node* chain : runs) {
+      *tail = chain;
+      while (*tail != nullptr) {
+        tail = &(*tail)->next;
+      }
+    }
+    relink_chain(head);
+    throw;
+  }
+  relink_chain(carry);
+}
+
+template <typename T, typename Allocator>
+void List<T, Allocator>::reverse() {
+  if (sz_ < 2) {
+    return;
+  }
+  Node* first = begin_;
+  Node* last = end_->prev;
+  for (Node* node = first; node != end_;) {
+    Node* next = node->next;
+    std::swap(node->prev, node->next);
+    node = next;
+  }
+  begin_ = last;
+  last->prev = nullptr;
+  first->next = end_;
+  end_->prev = first;
+}
+
+template <typename T, typename Allocator>
+size_t List<T, Allocator>::unique() {
+  return unique(std::equal_to<>());
+}
+
+template <typename T, typename Allocator>
+template <typename BinaryPredicate>
+size_t List<T, Allocator>::unique(BinaryPredicate pred) {
+  if (sz_ < 2) {
+    return 0;
+  }
+  size_t old_sz = sz_;
+  Node* prev = begin_;
+  while (prev->next != end_) {
+    if (pred(prev->val, prev->next->val)) {
+      delete_node(prev->next);
+    } else {
+      prev = prev->next;
+    }
+  }
+  return old_sz - sz_;
+}
+
 template <typename T, typename Allocator>
 typename List<T, Allocator>::iterator List<T, Allocator>::begin() {
-  return {begin_, 0};
+  return iterator(begin_);
 }
 
 template <typename T, typename Allocator>
 typename List<T, Allocator>::iterator List<T, Allocator>::end() {
-  return {end_, static_cast<std::ptrdiff_t>(sz_)};
+  return iterator(end_);
 }
 
 template <typename T, typename Allocator>
@@ -352,12 +640,12 @@ public:
   using reference = value_type&;
   using iterator_category = std::bidirectional_iterator_tag;
 
-  list_iterator(Node* node, difference_type shift)
-      : node_(node), shift_(shift) {}
+  list_iterator() = default;
+  list_iterator(Node* node) : node_(node) {}
 
-  operator const_iterator() const { return const_iterator(node_, shift_); }
-  reference operator*() { return node_->val; }
-  Node* operator->() { return node_; }
+  operator const_iterator() const { return const_iterator(node_); }
+  reference operator*() const { return node_->val; }
+  Node* operator->() const { return node_; }
 
   auto& operator+=(difference_type n);
   auto& operator-=(difference_type n);
@@ -371,25 +659,24 @@ public:
 
   std::strong_ordering operator<=>(const list_iterator& iter) const;
   bool operator==(const list_iterator& iter) const {
-    return std::is_eq(*this <=> iter);
+    return node_ == iter.node_;
   }
 
 private:
-  Node* node_;
-  difference_type shift_;
+  Node* node_{nullptr};
 };
 
 template <typename T, typename Allocator>
 template <bool IsConst>
 auto& List<T, Allocator>::list_iterator<IsConst>::operator+=(
     difference_type n) {
-  for (size_t i = 0; i < static_cast<size_t>(std::abs(n)); ++i) {
-    if (n > 0) {
+  if (n >= 0) {
+    for (; n > 0; --n) {
       node_ = node_->next;
-      ++shift_;
-    } else {
+    }
+  } else {
+    for (; n < 0; ++n) {
       node_ = node_->prev;
-      --shift_;
     }
   }
   return *this;
@@ -405,20 +692,22 @@ auto& List<T, Allocator>::list_iterator<IsConst>::operator-=(
 template <typename T, typename Allocator>
 template <bool IsConst>
 auto& List<T, Allocator>::list_iterator<IsConst>::operator++() {
-  return *this += 1;
+  node_ = node_->next;
+  return *this;
 }
 
 template <typename T, typename Allocator>
 template <bool IsConst>
 auto& List<T, Allocator>::list_iterator<IsConst>::operator--() {
-  return *this -= 1;
+  node_ = node_->prev;
+  return *this;
 }
 
 template <typename T, typename Allocator>
 template <bool IsConst>
 auto List<T, Allocator>::list_iterator<IsConst>::operator++(int) {
   list_iterator tmp(*this);
-  *this += 1;
+  node_ = node_->next;
   return tmp;
 }
 
@@ -426,7 +715,7 @@ template <typename T, typename Allocator>
 template <bool IsConst>
 auto List<T, Allocator>::list_iterator<IsConst>::operator--(int) {
   list_iterator tmp(*this);
-  *this -= 1;
+  node_ = node_->prev;
   return tmp;
 }
 
@@ -452,18 +741,36 @@ template <typename T, typename Allocator>
 template <bool IsConst>
 auto List<T, Allocator>::list_iterator<IsConst>::operator-(
     const list_iterator& iter) const {
-  return shift_ - iter.shift_;
+  Node* from_iter = iter.node_;
+  Node* from_this = node_;
+  for (difference_type steps = 0;; ++steps) {
+    if (from_iter == node_) {
+      return steps;
+    }
+    if (from_this == iter.node_) {
+      return -steps;
+    }
+    if (from_iter != nullptr) {
+      from_iter = from_iter->next;
+    }
+    if (from_this != nullptr) {
+      from_this = from_this->next;
+    }
+  }
 }
 
 template <typename T, typename Allocator>
 template <bool IsConst>
 std::strong_ordering List<T, Allocator>::list_iterator<IsConst>::operator<=>(
     const list_iterator& iter) const {
-  if (shift_ < iter.shift_) {
+  if (node_ == iter.node_) {
+    return std::strong_ordering::equal;
+  }
+  if (iter.node_->next == nullptr) {
     return std::strong_ordering::less;
   }
-  if (shift_ > iter.shift_) {
+  if (node_->next == nullptr) {
     return std::strong_ordering::greater;
   }
-  return std::strong_ordering::equal;
+  return *this - iter <=> 0;
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <new>
+
+struct SizeClasses {
+  static const std::size_t kGranularity = 16;
+  static const std::size_t kMaxPooledSz = 512;
+  static const std::size_t kClassesNum = kMaxPooledSz / kGranularity;
+
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  static bool is_pooled(std::size_t bytes, std::size_t alignment) {
+    return bytes <= kMaxPooledSz && alignment <= kGranularity;
+  }
+  static std::size_t class_of(std::size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / kGranularity;
+  }
+};
+
+class SlabList {
+public:
+  SlabList() = default;
+  SlabList(const SlabList& other) = delete;
+  SlabList& operator=(const SlabList& other) = delete;
+  ~SlabList();
+
+  template <typename Function>
+  void carve(std::size_t slab_sz, std::size_t size_class, Function function);
+
+  std::size_t count() const { return count_; }
+
+private:
+  struct alignas(SizeClasses::kGranularity) Slab {
+    Slab* next;
+  };
+
+  Slab* slabs_{nullptr};
+  std::size_t count_{0};
+};
+
+inline SlabList::~SlabList() {
+  while (slabs_ != nullptr) {
+    Slab* next = slabs_->next;
+    ::operator delete(slabs_);
+    slabs_ = next;
+  }
+}
+
+template <typename Function>
+void SlabList::carve(std::size_t slab_sz, std::size_t size_class,
+                     Function function) {
+  std::size_t block_sz = (size_class + 1) * SizeClasses::kGranularity;
+  auto* slab = static_cast<Slab*>(::operator new(slab_sz));
+  slab->next = slabs_;
+  slabs_ = slab;
+  ++count_;
+  char* first_block = reinterpret_cast<char*>(slab + 1);
+  for (std::size_t i = (slab_sz - sizeof(Slab)) / block_sz; i-- > 0;) {
+    function(reinterpret_cast<SizeClasses::FreeNode*>(first_block +
+                                                       i * block_sz));
+  }
+}
+
+class PoolResource {
+public:
+  PoolResource() = default;
+  PoolResource(const PoolResource& other) = delete;
+  PoolResource& operator=(const PoolResource& other) = delete;
+
+  void* allocate(std::size_t bytes, std::size_t alignment);
+  void deallocate(void* ptr, std::size_t bytes, std::size_t alignment);
+
+  std::size_t slabs_count() const { return slabs_.count(); }
+
+private:
+  using FreeNode = SizeClasses::FreeNode;
+
+  static const std::size_t kSlabSz = 16 * 1024;
+
+  FreeNode* free_lists_[SizeClasses::kClassesNum]{};
+  SlabList slabs_;
+
+  void refill(std::size_t size_class);
+};
+
+inline void PoolResource::refill(std::size_t size_class) {
+  FreeNode*& free_list = free_lists_[size_class];
+  slabs_.carve(kSlabSz, size_class, [&free_list](FreeNode* node) {
+    node->next = free_list;
+    free_list = node;
+  });
+}
+
+inline void* PoolResource::allocate(std::size_t bytes, std::size_t alignment) {
+  if (!SizeClasses::is_pooled(bytes, alignment)) {
+    return ::operator new(bytes, std::align_val_t(alignment));
+  }
+  std::size_t size_class = SizeClasses::class_of(bytes);
+  if (free_lists_[size_class] == nullptr) {
+    refill(size_class);
+  }
+  FreeNode* node = free_lists_[size_class];
+  free_lists_[size_class] = node->next;
+  return node;
+}
+
+inline void PoolResource::deallocate(void* ptr, std::size_t bytes,
+                                     std::size_t alignment) {
+  if (!SizeClasses::is_pooled(bytes, alignment)) {
+    ::operator delete(ptr, bytes, std::align_val_t(alignment));
+    return;
+  }
+  auto* node = static_cast<FreeNode*>(ptr);
+  std::size_t size_class = SizeClasses::class_of(bytes);
+  node->next = free_lists_[size_class];
+  free_lists_[size_class] = node;
+}
+
+// PoolResource is not synchronized, so there is no shared default resource:
+// every PoolAllocator must be bound to a resource owned by a single thread.
+template <typename T>
+struct PoolAllocator {
+  using value_type = T;
+  using pointer = value_type*;
+
+  PoolAllocator(PoolResource& resource) : resource(&resource) {}
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& other) : resource(other.resource) {}
+
+  pointer allocate(std::size_t size) {
+    return static_cast<pointer>(
+        resource->allocate(sizeof(value_type) * size, alignof(value_type)));
+  }
+  void deallocate(T* ptr, std::size_t size) {
+    resource->deallocate(ptr, sizeof(value_type) * size, alignof(value_type));
+  }
+
+  bool operator==(const PoolAllocator& other) const {
+    return resource == other.resource;
+  }
+
+  template <class U>
+  struct rebind {  // NOLINT
+    using other = PoolAllocator<U>;
+  };
+
+  PoolResource* resource;
+};
@@ -0,0 +1,178 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pool_allocator.h"
+
+class CentralPool {
+public:
+  static const std::size_t kBatchSz = 32;
+
+  using FreeNode = SizeClasses::FreeNode;
+
+  struct Batch {
+    FreeNode* head;
+    std::size_t count;
+  };
+
+  CentralPool() = default;
+  CentralPool(const CentralPool& other) = delete;
+  CentralPool& operator=(const CentralPool& other) = delete;
+
+  Batch fetch(std::size_t size_class);
+  void give_back(std::size_t size_class, Batch batch);
+
+  static CentralPool& instance();
+
+private:
+  static const std::size_t kSlabSz = 64 * 1024;
+
+  std::mutex mutex_;
+  std::vector<Batch> batches_[SizeClasses::kClassesNum];
+  SlabList slabs_;
+
+  void refill(std::size_t size_class);
+};
+
+inline CentralPool& CentralPool::instance() {
+  static CentralPool pool;
+  return pool;
+}
+
+inline void CentralPool::refill(std::size_t size_class) {
+  std::vector<Batch>& batches = batches_[size_class];
+  Batch batch{nullptr, 0};
+  slabs_.carve(kSlabSz, size_class, [&batches, &batch](FreeNode* node) {
+    node->next = batch.head;
+    batch.head = node;
+    if (++batch.count == kBatchSz) {
+      batches.push_back(batch);
+      batch = {nullptr, 0};
+    }
+  });
+  if (batch.count != 0) {
+    batches.push_back(batch);
+  }
+}
+
+inline CentralPool::Batch CentralPool::fetch(std::size_t size_class) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (batches_[size_class].empty()) {
+    refill(size_class);
+  }
+  Batch batch = batches_[size_class].back();
+  batches_[size_class].pop_back();
+  return batch;
+}
+
+inline void CentralPool::give_back(std::size_t size_class, Batch batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  batches_[size_class].push_back(batch);
+}
+
+class ThreadCache {
+public:
+  ThreadCache() : central_(CentralPool::instance()) {}
+  ThreadCache(const ThreadCache& other) = delete;
+  ThreadCache& operator=(const ThreadCache& other) = delete;
+  ~ThreadCache();
+
+  void* allocate(std::size_t bytes, std::size_t alignment);
+  void deallocate(void* ptr, std::size_t bytes, std::size_t alignment);
+
+  static ThreadCache& local();
+
+private:
+  using FreeNode = CentralPool::FreeNode;
+  using Batch = CentralPool::Batch;
+
+  CentralPool& central_;
+  Batch lists_[SizeClasses::kClassesNum]{};
+};
+
+inline ThreadCache::~ThreadCache() {
+  for (std::size_t size_class = 0; size_class < SizeClasses::kClassesNum;
+       ++size_class) {
+    if (lists_[size_class].count != 0) {
+      central_.give_back(size_class, lists_[size_class]);
+    }
+  }
+}
+
+inline ThreadCache& ThreadCache::local() {
+  thread_local ThreadCache cache;
+  return cache;
+}
+
+inline void* ThreadCache::allocate(std::size_t bytes, std::size_t alignment) {
+  if (!SizeClasses::is_pooled(bytes, alignment)) {
+    return ::operator new(bytes, std::align_val_t(alignment));
+  }
+  std::size_t size_class = SizeClasses::class_of(bytes);
+  Batch& list = lists_[size_class];
+  if (list.count == 0) {
+    list = central_.fetch(size_class);
+  }
+  FreeNode* node = list.head;
+  list.head = node->next;
+  --list.count;
+  return node;
+}
+
+inline void ThreadCache::deallocate(void* ptr, std::size_t bytes,
+                                    std::size_t alignment) {
+  if (!SizeClasses::is_pooled(bytes, alignment)) {
+    ::operator delete(ptr, bytes, std::align_val_t(alignment));
+    return;
+  }
+  std::size_t size_class = SizeClasses::class_of(bytes);
+  Batch& list = lists_[size_class];
+  auto* node = static_cast<FreeNode*>(ptr);
+  node->next = list.head;
+  list.head = node;
+  if (++list.count < 2 * CentralPool::kBatchSz) {
+    return;
+  }
+  Batch batch{list.head, CentralPool::kBatchSz};
+  FreeNode* last = list.head;
+  for (std::size_t i = 1; i < CentralPool::kBatchSz; ++i) {
+    last = last->next;
+  }
+  list.head = last->next;
+  list.count -= CentralPool::kBatchSz;
+  last->next = nullptr;
+  central_.give_back(size_class, batch);
+}
+
+template <typename T>
+struct ThreadCachingAllocator {
+  using value_type = T;
+  using pointer = value_type*;
+  using is_always_equal = std::true_type;
+
+  ThreadCachingAllocator() = default;
+  template <typename U>
+  ThreadCachingAllocator(const ThreadCachingAllocator<U>& /*unused*/) {}
+
+  pointer allocate(std::size_t size) {
+    return static_cast<pointer>(ThreadCache::local().allocate(
+        sizeof(value_type) * size, alignof(value_type)));
+  }
+  void deallocate(T* ptr, std::size_t size) {
+    ThreadCache::local().deallocate(ptr, sizeof(value_type) * size,
+                                    alignof(value_type));
+  }
+
+  bool operator==(const ThreadCachingAllocator& /*unused*/) const {
+    return true;
+  }
+
+  template <class U>
+  struct rebind {  // NOLINT
+    using other = ThreadCachingAllocator<U>;
+  };
+};
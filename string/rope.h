@@ -0,0 +1,458 @@
+#pragma once
+#include <compare>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "string.h"
+
+class Rope {
+public:
+  Rope() = default;
+  Rope(const char* first_symbol_ptr);
+  Rope(int number, char symbol);
+  Rope(const String& string);
+
+  char operator[](size_t index) const;
+
+  Rope& operator+=(char symbol);
+  Rope& operator+=(const char* right_string);
+  Rope& operator+=(const String& right_string);
+  Rope& operator+=(const Rope& right_rope);
+
+  size_t length() const;
+  size_t size() const;
+
+  void push_back(char symbol);
+  void pop_back();
+
+  char front() const;
+  char back() const;
+
+  Rope substr(size_t start, size_t count) const;
+  void insert(size_t pos, const Rope& rope);
+  void erase(size_t pos, size_t count);
+  size_t find(const String& substring) const;
+  size_t rfind(const String& substring) const;
+
+  bool empty() const;
+  void clear();
+
+  String flatten() const;
+
+  template <typename Function>
+  void for_each_chunk(Function function) const;
+
+private:
+  struct Node;
+  using NodePtr = std::shared_ptr<const Node>;
+
+  static const size_t kLeafSz = 512;
+
+  NodePtr root_;
+  String tail_;
+
+  void flush_tail();
+
+  static size_t length(const NodePtr& node);
+  static int height(const NodePtr& node);
+
+  template <typename Function>
+  void for_each_match(const String& substring, Function function) const;
+
+  static NodePtr make_leaf(std::shared_ptr<const String> chunk, size_t offset,
+                           size_t len);
+  static NodePtr make_node(NodePtr left, NodePtr right);
+  static NodePtr balance(NodePtr left, NodePtr right);
+  static NodePtr join(NodePtr left, NodePtr right);
+  static std::pair<NodePtr, NodePtr> split(const NodePtr& node, size_t pos);
+
+  template <typename Function>
+  bool for_each_chunk_while(Function function) const;
+  template <typename Function>
+  static bool for_each_chunk_while(const NodePtr& node, Function& function);
+
+  Rope(NodePtr root) : root_(std::move(root)) {}
+};
+
+bool operator==(const Rope& rope1, const Rope& rope2);
+bool operator!=(const Rope& rope1, const Rope& rope2);
+std::strong_ordering operator<=>(const Rope& rope1, const Rope& rope2);
+
+Rope operator+(const Rope& left_rope, char symbol);
+Rope operator+(char symbol, const Rope& right_rope);
+Rope operator+(const Rope& left_rope, const Rope& right_rope);
+
+struct Rope::Node {
+  NodePtr left;
+  NodePtr right;
+  std::shared_ptr<const String> chunk;
+  size_t offset{0};
+  size_t len{0};
+  int height{0};
+};
+
+inline Rope::Rope(const char* first_symbol_ptr)
+    : Rope(String(first_symbol_ptr)) {}
+
+inline Rope::Rope(int number, char symbol) : Rope(String(number, symbol)) {}
+
+inline Rope::Rope(const String& string) {
+  if (!string.empty()) {
+    root_ = make_leaf(std::make_shared<const String>(string), 0,
+                      string.length());
+  }
+}
+
+inline size_t Rope::length(const Rope::NodePtr& node) {
+  return node == nullptr ? 0 : node->len;
+}
+
+inline int Rope::height(const Rope::NodePtr& node) {
+  return node == nullptr ? -1 : node->height;
+}
+
+inline Rope::NodePtr Rope::make_leaf(std::shared_ptr<const String> chunk,
+                                     size_t offset, size_t len) {
+  auto leaf = std::make_shared<Node>();
+  leaf->chunk = std::move(chunk);
+  leaf->offset = offset;
+  leaf->len = len;
+  return leaf;
+}
+
+inline Rope::NodePtr Rope::make_node(NodePtr left, NodePtr right) {
+  auto node = std::make_shared<Node>();
+  node->len = left->len + right->len;
+  node->height = std::max(left->height, right->height) + 1;
+  node->left = std::move(left);
+  node->right = std::move(right);
+  return node;
+}
+
+inline Rope::NodePtr Rope::balance(NodePtr left, NodePtr right) {
+  if (height(left) > height(right) + 1) {
+    if (height(left->left) >= height(left->right)) {
+      return make_node(left->left, make_node(left->right, std::move(right)));
+    }
+    return make_node(make_node(left->left, left->right->left),
+                     make_node(left->right->right, std::move(right)));
+  }
+  if (height(right) > height(left) + 1) {
+    if (height(right->right) >= height(right->left)) {
+      return make_node(make_node(std::move(left), right->left), right->right);
+    }
+    return make_node(make_node(std::move(left), right->left->left),
+                     make_node(right->left->right, right->right));
+  }
+  return make_node(std::move(left), std::move(right));
+}
+
+inline Rope::NodePtr Rope::join(NodePtr left, NodePtr right) {
+  if (left == nullptr) {
+    return right;
+  }
+  if (right == nullptr) {
+    return left;
+  }
+  if (left->height == 0 && right->height == 0 &&
+      left->len + right->len <= kLeafSz) {
+    auto chunk = std::make_shared<String>();
+    chunk->reserve(left->len + right->len + 1);
+    chunk->append(left->chunk->data() + left->offset, left->len);
+    chunk->append(right->chunk->data() + right->offset, right->len);
+    return make_leaf(std::move(chunk), 0, left->len + right->len);
+  }
+  if (left->height > right->height + 1) {
+    return balance(left->left, join(left->right, std::move(right)));
+  }
+  if (right->height > left->height + 1) {
+    return balance(join(std::move(left), right->left), right->right);
+  }
+  return make_node(std::move(left), std::move(right));
+}
+
+inline std::pair<Rope::NodePtr, Rope::NodePtr> Rope::split(const NodePtr& node,
+                                                           size_t pos) {
+  if (node == nullptr) {
+    return {nullptr, nullptr};
+  }
+  if (pos == 0) {
+    return {nullptr, node};
+  }
+  if (pos >= node->len) {
+    return {node, nullptr};
+  }
+  if (node->height == 0) {
+    return {make_leaf(node->chunk, node->offset, pos),
+            make_leaf(node->chunk, node->offset + pos, node->len - pos)};
+  }
+  if (pos <= node->left->len) {
+    auto [left, right] = split(node->left, pos);
+    return {std::move(left), join(std::move(right), node->right)};
+  }
+  auto [left, right] = split(node->right, pos - node->left->len);
+  return {join(node->left, std::move(left)), std::move(right)};
+}
+
+inline void Rope::flush_tail() {
+  if (tail_.empty()) {
+    return;
+  }
+  size_t tail_len = tail_.length();
+  root_ = join(root_, make_leaf(std::make_shared<const String>(tail_), 0,
+                                tail_len));
+  tail_.clear();
+}
+
+inline char Rope::operator[](size_t index) const {
+  if (index >= length(root_)) {
+    return tail_[index - length(root_)];
+  }
+  const Node* node = root_.get();
+  while (node->height != 0) {
+    if (index < node->left->len) {
+      node = node->left.get();
+    } else {
+      index -= node->left->len;
+      node = node->right.get();
+    }
+  }
+  return (*node->chunk)[node->offset + index];
+}
+
+inline Rope& Rope::operator+=(char symbol) {
+  push_back(symbol);
+  return *this;
+}
+
+inline Rope& Rope::operator+=(const char* right_string) {
+  size_t right_string_length = strlen(right_string);
+  if (tail_.length() + right_string_length <= kLeafSz) {
+    tail_.append(right_string, right_string_length);
+    return *this;
+  }
+  return *this += Rope(right_string);
+}
+
+inline Rope& Rope::operator+=(const String& right_string) {
+  if (tail_.length() + right_string.length() <= kLeafSz) {
+    tail_ += right_string;
+    return *this;
+  }
+  return *this += Rope(right_string);
+}
+
+inline Rope& Rope::operator+=(const Rope& right_rope) {
+  Rope right(right_rope);
+  right.flush_tail();
+  flush_tail();
+  root_ = join(root_, right.root_);
+  return *this;
+}
+
+inline size_t Rope::length() const { return length(root_) + tail_.length(); }
+
+inline size_t Rope::size() const { return length(); }
+
+inline void Rope::push_back(char symbol) {
+  if (tail_.length() == kLeafSz) {
+    flush_tail();
+  }
+  tail_.push_back(symbol);
+}
+
+inline void Rope::pop_back() {
+  if (!tail_.empty()) {
+    tail_.pop_back();
+    return;
+  }
+  root_ = split(root_, length(root_) - 1).first;
+}
+
+inline char Rope::front() const { return operator[](0); }
+
+inline char Rope::back() const { return operator[](length() - 1); }
+
+inline Rope Rope::substr(size_t start, size_t count) const {
+  Rope whole(*this);
+  whole.flush_tail();
+  auto [left, right] = split(whole.root_, start);
+  return Rope(split(right, count).first);
+}
+
+inline void Rope::insert(size_t pos, const Rope& rope) {
+  Rope middle(rope);
+  middle.flush_tail();
+  flush_tail();
+  auto [left, right] = split(root_, pos);
+  root_ = join(join(std::move(left), middle.root_), std::move(right));
+}
+
+inline void Rope::erase(size_t pos, size_t count) {
+  flush_tail();
+  auto [left, right] = split(root_, pos);
+  root_ = join(std::move(left), split(right, count).second);
+}
+
+template <typename Function>
+void Rope::for_each_match(const String& substring, Function function) const {
+  size_t sub_len = substring.length();
+  std::vector<size_t> prefix(sub_len, 0);
+  for (size_t i = 1, matched = 0; i < sub_len; ++i) {
+    while (matched > 0 && substring[i] != substring[matched]) {
+      matched = prefix[matched - 1];
+    }
+    if (substring[i] == substring[matched]) {
+      ++matched;
+    }
+    prefix[i] = matched;
+  }
+  size_t pos = 0;
+  size_t matched = 0;
+  for_each_chunk_while([&](const char* chunk, size_t len) {
+    for (size_t i = 0; i < len; ++i, ++pos) {
+      while (matched > 0 && chunk[i] != substring[matched]) {
+        matched = prefix[matched - 1];
+      }
+      if (chunk[i] == substring[matched]) {
+        ++matched;
+      }
+      if (matched == sub_len) {
+        if (!function(pos + 1 - sub_len)) {
+          return false;
+        }
+        matched = prefix[matched - 1];
+      }
+    }
+    return true;
+  });
+}
+
+inline size_t Rope::find(const String& substring) const {
+  if (substring.empty()) {
+    return 0;
+  }
+  size_t result = length();
+  for_each_match(substring, [&result](size_t pos) {
+    result = pos;
+    return false;
+  });
+  return result;
+}
+
+inline size_t Rope::rfind(const String& substring) const {
+  size_t result = length();
+  if (substring.empty()) {
+    return result;
+  }
+  for_each_match(substring, [&result](size_t pos) {
+    result = pos;
+    return true;
+  });
+  return result;
+}
+
+inline bool Rope::empty() const { return length() == 0; }
+
+inline void Rope::clear() {
+  root_.reset();
+  tail_.clear();
+}
+
+template <typename Function>
+bool Rope::for_each_chunk_while(const NodePtr& node, Function& function) {
+  if (node == nullptr) {
+    return true;
+  }
+  if (node->height == 0) {
+    return function(node->chunk->data() + node->offset, node->len);
+  }
+  return for_each_chunk_while(node->left, function) &&
+         for_each_chunk_while(node->right, function);
+}
+
+template <typename Function>
+bool Rope::for_each_chunk_while(Function function) const {
+  if (!for_each_chunk_while(root_, function)) {
+    return false;
+  }
+  return tail_.empty() || function(tail_.data(), tail_.length());
+}
+
+template <typename Function>
+void Rope::for_each_chunk(Function function) const {
+  for_each_chunk_while([&function](const char* chunk, size_t len) {
+    function(chunk, len);
+    return true;
+  });
+}
+
+inline String Rope::flatten() const {
+  String result_string;
+  result_string.reserve(length() + 1);
+  for_each_chunk([&result_string](const char* chunk, size_t len) {
+    result_string.append(chunk, len);
+  });
+  return result_string;
+}
+
+inline std::ostream& operator<<(std::ostream& out, const Rope& rope) {
+  rope.for_each_chunk(
+      [&out](const char* chunk, size_t len) { out.write(chunk, len); });
+  return out;
+}
+
+inline bool operator==(const Rope& rope1, const Rope& rope2) {
+  return rope1.length() == rope2.length() && std::is_eq(rope1 <=> rope2);
+}
+
+inline bool operator!=(const Rope& rope1, const Rope& rope2) {
+  return !(rope1 == rope2);
+}
+
+inline std::strong_ordering operator<=>(const Rope& rope1, const Rope& rope2) {
+  std::vector<std::pair<const char*, size_t>> chunks;
+  rope2.for_each_chunk([&chunks](const char* chunk, size_t len) {
+    chunks.emplace_back(chunk, len);
+  });
+  size_t idx = 0;
+  size_t offset = 0;
+  int result = 0;
+  rope1.for_each_chunk([&](const char* chunk, size_t len) {
+    while (result == 0 && len > 0 && idx < chunks.size()) {
+      size_t count = std::min(len, chunks[idx].second - offset);
+      result = std::memcmp(chunk, chunks[idx].first + offset, count);
+      chunk += count;
+      len -= count;
+      offset += count;
+      if (offset == chunks[idx].second) {
+        ++idx;
+        offset = 0;
+      }
+    }
+  });
+  if (result != 0) {
+    return result <=> 0;
+  }
+  return rope1.length() <=> rope2.length();
+}
+
+inline Rope operator+(const Rope& left_rope, char symbol) {
+  Rope union_rope = left_rope;
+  union_rope += symbol;
+  return union_rope;
+}
+
+inline Rope operator+(char symbol, const Rope& right_rope) {
+  Rope union_rope(1, symbol);
+  union_rope += right_rope;
+  return union_rope;
+}
+
+inline Rope operator+(const Rope& left_rope, const Rope& right_rope) {
+  Rope union_rope = left_rope;
+  union_rope += right_rope;
+  return union_rope;
+}
@@ -1,29 +1,50 @@
 #pragma once
+#include <algorithm>
+#include <cctype>
+#include <compare>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
+#include <memory>
 
-class String {
-public:
-  String() : len_(0), cap_(0), string_(new char[cap_ + 1]) {
-    string_[0] = '\0';
-  }
-  String(const char* first_symbol_ptr);
-  String(int number, char symbol);
-  String(const String& other_string);
-
-  ~String();
+template <typename Allocator = std::allocator<char>>
+class BasicString {
+  using allocator_type =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<char>;
+  using allocator_traits = std::allocator_traits<allocator_type>;
 
-  void swap(String& second_string);
+public:
+  BasicString() : BasicString(Allocator()) {}
+  BasicString(const Allocator& alloc)
+      : alloc_(alloc), len_(0), cap_(0), string_(empty_buffer()) {}
+  BasicString(const char* first_symbol_ptr,
+              const Allocator& alloc = Allocator());
+  BasicString(int number, char symbol, const Allocator& alloc = Allocator());
+  BasicString(const BasicString& other_string);
+  BasicString(const BasicString& other_string, const Allocator& alloc);
+  BasicString(BasicString&& other_string) noexcept;
+
+  ~BasicString();
+
+  void swap(BasicString& second_string);
   void reserve(size_t new_cap);
 
-  String& operator=(const String& other_string);
+  BasicString& operator=(const BasicString& other_string);
+  BasicString& operator=(BasicString&& other_string) noexcept(
+      kIsNothrowMoveAssignable);
 
   char& operator[](size_t index);
   const char& operator[](size_t index) const;
 
-  String& operator+=(char symbol);
-  String& operator+=(const char* right_string);
-  String& operator+=(const String& right_string);
+  BasicString& operator+=(char symbol);
+  BasicString& operator+=(const char* right_string);
+  BasicString& operator+=(const BasicString& right_string);
+
+  BasicString& append(const char* chars, size_t count);
+
+  template <typename Operation>
+  void resize_and_overwrite(size_t count, Operation operation);
 
   size_t length() const;
   size_t size() const;
@@ -40,152 +61,319 @@ public:
   char* data();
   const char* data() const;
 
-  String substr(size_t start, size_t count) const;
-  size_t find(const String& substring) const;
-  size_t rfind(const String& substring) const;
+  BasicString substr(size_t start, size_t count) const;
+  size_t find(const BasicString& substring) const;
+  size_t rfind(const BasicString& substring) const;
 
   bool empty() const;
   void clear();
 
   void shrink_to_fit();
 
+  allocator_type get_allocator() const { return alloc_; }
+
 private:
+  static const bool kIsNothrowMoveAssignable =
+      allocator_traits::propagate_on_container_move_assignment::value ||
+      allocator_traits::is_always_equal::value;
+
+  allocator_type alloc_;
   size_t len_;
   size_t cap_;
   char* string_;
+
+  static char* empty_buffer();
+  char* writable_buffer();
+
+  void reallocate(size_t new_cap);
+  void deallocate();
+  void swap_data(BasicString& second_string);
 };
 
-String::String(int number, char symbol)
-    : len_(number), cap_(len_ + 1), string_(new char[cap_]) {
+using String = BasicString<>;
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(int number, char symbol,
+                                    const Allocator& alloc)
+    : alloc_(alloc),
+      len_(number),
+      cap_(len_ + 1),
+      string_(allocator_traits::allocate(alloc_, cap_)) {
   std::fill(string_, string_ + len_, symbol);
   string_[len_] = '\0';
 }
 
-String::String(const char* first_symbol_ptr)
-    : len_(std::strlen(first_symbol_ptr)),
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const char* first_symbol_ptr,
+                                    const Allocator& alloc)
+    : alloc_(alloc),
+      len_(std::strlen(first_symbol_ptr)),
       cap_(len_ + 1),
-      string_(new char[cap_]) {
+      string_(allocator_traits::allocate(alloc_, cap_)) {
   std::copy(first_symbol_ptr, first_symbol_ptr + cap_, string_);
 }
 
-String::String(const String& other_string) : String(other_string.data()) {}
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const BasicString& other_string)
+    : BasicString(other_string,
+                  allocator_traits::select_on_container_copy_construction(
+                      other_string.alloc_)) {}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(const BasicString& other_string,
+                                    const Allocator& alloc)
+    : alloc_(alloc),
+      len_(other_string.len_),
+      cap_(len_ + 1),
+      string_(allocator_traits::allocate(alloc_, cap_)) {
+  std::copy(other_string.string_, other_string.string_ + cap_, string_);
+}
+
+template <typename Allocator>
+BasicString<Allocator>::BasicString(BasicString&& other_string) noexcept
+    : alloc_(other_string.alloc_),
+      len_(other_string.len_),
+      cap_(other_string.cap_),
+      string_(other_string.string_) {
+  other_string.len_ = 0;
+  other_string.cap_ = 0;
+  other_string.string_ = empty_buffer();
+}
 
-String::~String() { delete[] string_; }
+template <typename Allocator>
+BasicString<Allocator>::~BasicString() {
+  deallocate();
+}
 
-void String::swap(String& second_string) {
+template <typename Allocator>
+char* BasicString<Allocator>::empty_buffer() {
+  static const char kEmptyString[1] = {'\0'};
+  return const_cast<char*>(kEmptyString);
+}
+
+template <typename Allocator>
+char* BasicString<Allocator>::writable_buffer() {
+  if (cap_ == 0) {
+    reallocate(1);
+  }
+  return string_;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::reallocate(size_t new_cap) {
+  char* sub_string = allocator_traits::allocate(alloc_, new_cap);
+  std::copy(string_, string_ + len_, sub_string);
+  sub_string[len_] = '\0';
+  deallocate();
+  cap_ = new_cap;
+  string_ = sub_string;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::deallocate() {
+  if (cap_ != 0) {
+    allocator_traits::deallocate(alloc_, string_, cap_);
+  }
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::swap_data(BasicString& second_string) {
   std::swap(len_, second_string.len_);
   std::swap(cap_, second_string.cap_);
   std::swap(string_, second_string.string_);
 }
 
-void String::reserve(size_t new_cap) {
-  cap_ = new_cap;
-  char* sub_string = new char[cap_];
-  std::copy(string_, string_ + len_, sub_string);
-  delete[] string_;
-  string_ = sub_string;
+template <typename Allocator>
+void BasicString<Allocator>::swap(BasicString& second_string) {
+  if (allocator_traits::propagate_on_container_swap::value) {
+    std::swap(alloc_, second_string.alloc_);
+  }
+  swap_data(second_string);
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::reserve(size_t new_cap) {
+  if (new_cap <= cap_) {
+    return;
+  }
+  reallocate(new_cap);
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator=(
+    const BasicString& other_string) {
+  if (this == &other_string) {
+    return *this;
+  }
+  BasicString temp(
+      other_string,
+      allocator_traits::propagate_on_container_copy_assignment::value
+          ? other_string.alloc_
+          : alloc_);
+  std::swap(alloc_, temp.alloc_);
+  swap_data(temp);
+  return *this;
 }
 
-String& String::operator=(const String& other_string) {
-  String temp(other_string);
-  swap(temp);
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator=(
+    BasicString&& other_string) noexcept(kIsNothrowMoveAssignable) {
+  if (this == &other_string) {
+    return *this;
+  }
+  if (!allocator_traits::propagate_on_container_move_assignment::value &&
+      alloc_ != other_string.alloc_) {
+    return *this = other_string;
+  }
+  BasicString temp(std::move(other_string));
+  if (allocator_traits::propagate_on_container_move_assignment::value) {
+    std::swap(alloc_, temp.alloc_);
+  }
+  swap_data(temp);
   return *this;
 }
 
-bool operator==(const String& string1, const String& string2) {
+template <typename Allocator>
+bool operator==(const BasicString<Allocator>& string1,
+                const BasicString<Allocator>& string2) {
   size_t len1 = string1.length();
-  size_t len2 = string2.length();
-  if (len1 != len2) {
+  if (len1 != string2.length()) {
     return false;
   }
-  const char* str1 = string1.data();
-  const char* str2 = string2.data();
-  for (size_t i = 0; i < len1; ++i) {
-    if (str1[i] != str2[i]) {
-      return false;
-    }
-  }
-  return true;
+  return std::memcmp(string1.data(), string2.data(), len1) == 0;
 }
 
-bool operator!=(const String& string1, const String& string2) {
+template <typename Allocator>
+bool operator!=(const BasicString<Allocator>& string1,
+                const BasicString<Allocator>& string2) {
   return !(string1 == string2);
 }
 
-bool operator<(const String& string1, const String& string2) {
+template <typename Allocator>
+std::strong_ordering operator<=>(const BasicString<Allocator>& string1,
+                                 const BasicString<Allocator>& string2) {
   size_t len1 = string1.length();
   size_t len2 = string2.length();
-  const char* str1 = string1.data();
-  const char* str2 = string2.data();
-  for (size_t i = 0; i < std::min(len1, len2); ++i) {
-    if (str1[i] != str2[i]) {
-      return str1[i] < str2[i];
-    }
-  }
-  if (len1 != len2) {
-    return len1 < len2;
+  int result = std::memcmp(string1.data(), string2.data(), std::min(len1, len2));
+  if (result != 0) {
+    return result <=> 0;
   }
-  return true;
+  return len1 <=> len2;
 }
 
-bool operator<=(const String& string1, const String& string2) {
+template <typename Allocator>
+bool operator<(const BasicString<Allocator>& string1,
+               const BasicString<Allocator>& string2) {
+  return std::is_lt(string1 <=> string2);
+}
+
+template <typename Allocator>
+bool operator<=(const BasicString<Allocator>& string1,
+                const BasicString<Allocator>& string2) {
   return !(string2 < string1);
 }
 
-bool operator>(const String& string1, const String& string2) {
+template <typename Allocator>
+bool operator>(const BasicString<Allocator>& string1,
+               const BasicString<Allocator>& string2) {
   return string2 < string1;
 }
 
-bool operator>=(const String& string1, const String& string2) {
+template <typename Allocator>
+bool operator>=(const BasicString<Allocator>& string1,
+                const BasicString<Allocator>& string2) {
   return !(string1 < string2);
 }
 
-char& String::operator[](size_t index) { return string_[index]; }
+template <typename Allocator>
+char& BasicString<Allocator>::operator[](size_t index) {
+  return writable_buffer()[index];
+}
 
-const char& String::operator[](size_t index) const { return string_[index]; }
+template <typename Allocator>
+const char& BasicString<Allocator>::operator[](size_t index) const {
+  return string_[index];
+}
 
-String& String::operator+=(char symbol) {
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator+=(char symbol) {
   push_back(symbol);
   return *this;
 }
 
-String& String::operator+=(const char* right_string) {
-  size_t right_string_length = strlen(right_string);
-  size_t union_length = len_ + right_string_length;
-  if (cap_ > union_length) {
-    std::copy(right_string, right_string + right_string_length, string_ + len_);
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator+=(
+    const char* right_string) {
+  return append(right_string, strlen(right_string));
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::operator+=(
+    const BasicString& right_string) {
+  return append(right_string.string_, right_string.len_);
+}
+
+template <typename Allocator>
+BasicString<Allocator>& BasicString<Allocator>::append(const char* chars,
+                                                       size_t count) {
+  if (count == 0) {
+    return *this;
+  }
+  size_t union_length = len_ + count;
+  if (cap_ <= union_length) {
+    size_t new_cap = 2 * union_length;
+    char* sub_string = allocator_traits::allocate(alloc_, new_cap);
+    std::copy(string_, string_ + len_, sub_string);
+    std::copy(chars, chars + count, sub_string + len_);
+    deallocate();
+    cap_ = new_cap;
+    string_ = sub_string;
   } else {
-    reserve(2 * union_length);
-    std::copy(right_string, right_string + right_string_length, string_ + len_);
+    std::copy(chars, chars + count, string_ + len_);
   }
   len_ = union_length;
   string_[len_] = '\0';
   return *this;
 }
 
-String& String::operator+=(const String& right_string) {
-  *this += right_string.string_;
-  return *this;
+template <typename Allocator>
+template <typename Operation>
+void BasicString<Allocator>::resize_and_overwrite(size_t count,
+                                                  Operation operation) {
+  if (cap_ <= count) {
+    reserve(std::max(count + 1, 2 * cap_));
+  }
+  len_ = operation(string_, count);
+  string_[len_] = '\0';
 }
 
-String operator+(const String& left_string, char symbol) {
-  String union_string = left_string;
+template <typename Allocator>
+BasicString<Allocator> operator+(const BasicString<Allocator>& left_string,
+                                 char symbol) {
+  BasicString<Allocator> union_string = left_string;
   union_string += symbol;
   return union_string;
 }
 
-String operator+(char symbol, const String& left_string) {
-  String union_string(1, symbol);
+template <typename Allocator>
+BasicString<Allocator> operator+(char symbol,
+                                 const BasicString<Allocator>& left_string) {
+  BasicString<Allocator> union_string(1, symbol, left_string.get_allocator());
   union_string += left_string;
   return union_string;
 }
-String operator+(const String& left_string, const String& right_string) {
-  String union_string = left_string;
+
+template <typename Allocator>
+BasicString<Allocator> operator+(const BasicString<Allocator>& left_string,
+                                 const BasicString<Allocator>& right_string) {
+  BasicString<Allocator> union_string = left_string;
   union_string += right_string;
   return union_string;
 }
 
-std::ostream& operator<<(std::ostream& out, const String& string) {
+template <typename Allocator>
+std::ostream& operator<<(std::ostream& out,
+                         const BasicString<Allocator>& string) {
   size_t len = string.length();
   const char* str = string.data();
   for (size_t i = 0; i < len; ++i) {
@@ -194,65 +382,149 @@ std::ostream& operator<<(std::ostream& out, const String& string) {
   return out;
 }
 
-std::istream& operator>>(std::istream& input, String& string) {
-  char cur_symbol;
-  input.get(cur_symbol);
-  while (!(input.eof()) && !static_cast<bool>(std::isspace(cur_symbol))) {
-    string.push_back(cur_symbol);
-    input.get(cur_symbol);
+template <typename Allocator, typename Predicate>
+std::istream& ExtractUntil(std::istream& input, BasicString<Allocator>& string,
+                           Predicate is_stop_symbol, bool skip_stop_symbol) {
+  static const size_t kChunkSz = 256;
+  using traits = std::istream::traits_type;
+
+  std::streambuf* buffer = input.rdbuf();
+  char chunk[kChunkSz];
+  size_t chunk_len = 0;
+  size_t extracted = 0;
+  std::ios_base::iostate state = std::ios_base::goodbit;
+
+  traits::int_type cur_symbol = buffer->sgetc();
+  while (true) {
+    if (traits::eq_int_type(cur_symbol, traits::eof())) {
+      state |= std::ios_base::eofbit;
+      break;
+    }
+    char symbol = traits::to_char_type(cur_symbol);
+    if (is_stop_symbol(symbol)) {
+      if (skip_stop_symbol) {
+        buffer->sbumpc();
+        ++extracted;
+      }
+      break;
+    }
+    if (chunk_len == kChunkSz) {
+      if (string.empty()) {
+        string.reserve(kChunkSz + buffer->in_avail() + 1);
+      }
+      string.append(chunk, chunk_len);
+      chunk_len = 0;
+    }
+    chunk[chunk_len++] = symbol;
+    ++extracted;
+    cur_symbol = buffer->snextc();
+  }
+  string.append(chunk, chunk_len);
+
+  if (extracted == 0) {
+    state |= std::ios_base::failbit;
   }
+  input.setstate(state);
   return input;
 }
 
-size_t String::length() const { return len_; }
+template <typename Allocator>
+std::istream& operator>>(std::istream& input, BasicString<Allocator>& string) {
+  std::istream::sentry sentry(input);
+  if (!sentry) {
+    return input;
+  }
+  string.clear();
+  return ExtractUntil(
+      input, string,
+      [](char symbol) {
+        return static_cast<bool>(
+            std::isspace(static_cast<unsigned char>(symbol)));
+      },
+      false);
+}
 
-size_t String::size() const { return len_; }
+template <typename Allocator>
+std::istream& getline(std::istream& input, BasicString<Allocator>& string,
+                      char delim = '\n') {
+  std::istream::sentry sentry(input, true);
+  if (!sentry) {
+    return input;
+  }
+  string.clear();
+  return ExtractUntil(
+      input, string, [delim](char symbol) { return symbol == delim; }, true);
+}
 
-size_t String::capacity() const { return cap_ - 1; }
+template <typename Allocator>
+size_t BasicString<Allocator>::length() const {
+  return len_;
+}
 
-void String::push_back(char symbol) {
-  if (len_ < cap_ - 1) {
-    string_[len_] = symbol;
-    string_[len_ + 1] = '\0';
-    ++len_;
-  } else {
-    reserve(2 * cap_);
-    string_[len_] = symbol;
-    ++len_;
-    string_[len_] = '\0';
+template <typename Allocator>
+size_t BasicString<Allocator>::size() const {
+  return len_;
+}
+
+template <typename Allocator>
+size_t BasicString<Allocator>::capacity() const {
+  return cap_ == 0 ? 0 : cap_ - 1;
+}
+
+template <typename Allocator>
+void BasicString<Allocator>::push_back(char symbol) {
+  if (len_ + 1 >= cap_) {
+    reserve(cap_ == 0 ? 2 : 2 * cap_);
   }
+  string_[len_] = symbol;
+  ++len_;
+  string_[len_] = '\0';
 }
 
-void String::pop_back() {
+template <typename Allocator>
+void BasicString<Allocator>::pop_back() {
   --len_;
   string_[len_] = '\0';
 }
 
-char& String::front() { return string_[0]; }
+template <typename Allocator>
+char& BasicString<Allocator>::front() {
+  return writable_buffer()[0];
+}
 
-const char& String::front() const { return string_[0]; }
+template <typename Allocator>
+const char& BasicString<Allocator>::front() const {
+  return string_[0];
+}
 
-char& String::back() {
+template <typename Allocator>
+char& BasicString<Allocator>::back() {
   if (len_ == 0) {
-    return string_[0];
+    return writable_buffer()[0];
   }
   return string_[len_ - 1];
 }
 
-const char& String::back() const {
+template <typename Allocator>
+const char& BasicString<Allocator>::back() const {
   if (len_ == 0) {
     return string_[0];
   }
   return string_[len_ - 1];
 }
 
-String String::substr(size_t start, size_t count) const {
-  String result_string(count, '\0');
+template <typename Allocator>
+BasicString<Allocator> BasicString<Allocator>::substr(size_t start,
+                                                      size_t count) const {
+  BasicString result_string(count, '\0',
+                            allocator_traits::
+                                select_on_container_copy_construction(alloc_));
   std::copy(string_ + start, string_ + start + count, result_string.string_);
   return result_string;
 }
 
-size_t String::find(const String& substring) const {
+template <typename Allocator>
+size_t BasicString<Allocator>::find(const BasicString& substring) const {
   char* result = strstr(string_, substring.string_);
   if (result == nullptr) {
     return len_;
@@ -260,7 +532,8 @@ size_t String::find(const String& substring) const {
   return (result - string_);
 }
 
-size_t String::rfind(const String& substring) const {
+template <typename Allocator>
+size_t BasicString<Allocator>::rfind(const BasicString& substring) const {
   if (len_ < substring.len_) {
     return len_;
   }
@@ -280,24 +553,97 @@ size_t String::rfind(const String& substring) const {
   return ptr1;
 }
 
-bool String::empty() const { return (len_ == 0); }
+template <typename Allocator>
+bool BasicString<Allocator>::empty() const {
+  return (len_ == 0);
+}
 
-void String::clear() {
-  string_[0] = '\0';
+template <typename Allocator>
+void BasicString<Allocator>::clear() {
+  if (cap_ != 0) {
+    string_[0] = '\0';
+  }
   len_ = 0;
 }
 
-void String::shrink_to_fit() {
+template <typename Allocator>
+void BasicString<Allocator>::shrink_to_fit() {
   if (cap_ > len_ + 1) {
-    cap_ = len_ + 1;
-    char* sub_string = new char[cap_];
-    std::copy(string_, string_ + len_, sub_string);
-    delete[] string_;
-    string_ = sub_string;
-    string_[len_] = '\0';
+    reallocate(len_ + 1);
   }
 }
 
-char* String::data() { return string_; }
+template <typename Allocator>
+char* BasicString<Allocator>::data() {
+  return writable_buffer();
+}
+
+template <typename Allocator>
+const char* BasicString<Allocator>::data() const {
+  return string_;
+}
+
+inline uint64_t HashMix(uint64_t lhs, uint64_t rhs) {
+  __uint128_t product = static_cast<__uint128_t>(lhs) * rhs;
+  return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t HashRead(const char* ptr, size_t count) {
+  uint64_t word = 0;
+  std::memcpy(&word, ptr, count);
+  return word;
+}
 
-const char* String::data() const { return string_; }
\ No newline at end of file
+inline uint64_t HashBytes(const char* bytes, size_t len,
+                          uint64_t seed = 0) {
+  static const uint64_t kSecret0 = 0xa0761d6478bd642fULL;
+  static const uint64_t kSecret1 = 0xe7037ed1a0b428dbULL;
+  static const uint64_t kSecret2 = 0x8ebc6af09c88c6e3ULL;
+  static const uint64_t kSecret3 = 0x589965cc75374cc3ULL;
+
+  seed ^= HashMix(seed ^ kSecret0, kSecret1);
+  uint64_t first = 0;
+  uint64_t second = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t middle = (len >> 3) << 2;
+      first = (HashRead(bytes, 4) << 32) | HashRead(bytes + middle, 4);
+      second = (HashRead(bytes + len - 4, 4) << 32) |
+               HashRead(bytes + len - 4 - middle, 4);
+    } else if (len > 0) {
+      first = (static_cast<uint64_t>(static_cast<unsigned char>(bytes[0]))
+               << 16) |
+              (static_cast<uint64_t>(
+                   static_cast<unsigned char>(bytes[len >> 1]))
+               << 8) |
+              static_cast<unsigned char>(bytes[len - 1]);
+    }
+  } else {
+    size_t rest = len;
+    const char* cur = bytes;
+    uint64_t seed1 = seed;
+    uint64_t seed2 = seed;
+    for (; rest > 48; rest -= 48, cur += 48) {
+      seed = HashMix(HashRead(cur, 8) ^ kSecret1, HashRead(cur + 8, 8) ^ seed);
+      seed1 = HashMix(HashRead(cur + 16, 8) ^ kSecret2,
+                      HashRead(cur + 24, 8) ^ seed1);
+      seed2 = HashMix(HashRead(cur + 32, 8) ^ kSecret3,
+                      HashRead(cur + 40, 8) ^ seed2);
+    }
+    seed ^= seed1 ^ seed2;
+    for (; rest > 16; rest -= 16, cur += 16) {
+      seed = HashMix(HashRead(cur, 8) ^ kSecret1, HashRead(cur + 8, 8) ^ seed);
+    }
+    first = HashRead(cur + rest - 16, 8);
+    second = HashRead(cur + rest - 8, 8);
+  }
+  return HashMix(kSecret1 ^ len,
+                 HashMix(first ^ kSecret1, second ^ seed));
+}
+
+template <typename Allocator>
+struct std::hash<BasicString<Allocator>> {
+  size_t operator()(const BasicString<Allocator>& string) const noexcept {
+    return HashBytes(string.data(), string.length());
+  }
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <charconv>
+#include <concepts>
+#include <string_view>
+
+#include "../biginteger_and_rational/biginteger_rational.h"
+#include "string.h"
+
+inline constexpr size_t kMaxFloatSz = 15;
+inline constexpr size_t kMaxDoubleSz = 24;
+
+template <std::integral Integer>
+size_t FormattedSize(Integer number) {
+  size_t size = 1;
+  if constexpr (std::is_signed_v<Integer>) {
+    size += (number < 0) ? 1 : 0;
+  }
+  while (number / 10 != 0) {
+    number /= 10;
+    ++size;
+  }
+  return size;
+}
+
+inline size_t FormattedSize(char /*unused*/) { return 1; }
+
+inline size_t FormattedSize(bool value) { return value ? 4 : 5; }
+
+inline size_t FormattedSize(float /*unused*/) { return kMaxFloatSz; }
+
+inline size_t FormattedSize(double /*unused*/) { return kMaxDoubleSz; }
+
+inline size_t FormattedSize(std::string_view string) { return string.size(); }
+
+template <typename Allocator>
+size_t FormattedSize(const BasicString<Allocator>& string) {
+  return string.length();
+}
+
+inline size_t FormattedSize(const BigInteger& num) {
+  static const int kMaxDigitsNum = 9;
+  const std::vector<int>& digits = num.data();
+  if (digits.empty()) {
+    return 1;
+  }
+  return (num.isNegative() ? 1 : 0) + FormattedSize(digits.back()) +
+         kMaxDigitsNum * (digits.size() - 1);
+}
+
+template <std::integral Integer>
+char* FormatInto(char* out, char* last, Integer number) {
+  return std::to_chars(out, last, number).ptr;
+}
+
+inline char* FormatInto(char* out, char* /*unused*/, char symbol) {
+  *out = symbol;
+  return out + 1;
+}
+
+inline char* FormatInto(char* out, char* /*unused*/, bool value) {
+  std::string_view word = value ? "true" : "false";
+  return std::copy(word.begin(), word.end(), out);
+}
+
+inline char* FormatInto(char* out, char* last, float number) {
+  return std::to_chars(out, last, number).ptr;
+}
+
+inline char* FormatInto(char* out, char* last, double number) {
+  return std::to_chars(out, last, number).ptr;
+}
+
+inline char* FormatInto(char* out, char* /*unused*/, std::string_view string) {
+  return std::copy(string.begin(), string.end(), out);
+}
+
+template <typename Allocator>
+char* FormatInto(char* out, char* /*unused*/,
+                 const BasicString<Allocator>& string) {
+  return std::copy(string.data(), string.data() + string.length(), out);
+}
+
+inline char* FormatInto(char* out, char* last, const BigInteger& num) {
+  static const int kMaxDigitsNum = 9;
+  const std::vector<int>& digits = num.data();
+  if (digits.empty()) {
+    *out = '0';
+    return out + 1;
+  }
+  if (num.isNegative()) {
+    *out++ = '-';
+  }
+  out = FormatInto(out, last, digits.back());
+  for (size_t i = digits.size() - 2; i != size_t(-1); --i) {
+    int digit = digits[i];
+    for (int j = kMaxDigitsNum - 1; j >= 0; --j) {
+      out[j] = static_cast<char>('0' + digit % 10);
+      digit /= 10;
+    }
+    out += kMaxDigitsNum;
+  }
+  return out;
+}
+
+template <typename Arg>
+const Arg& FormatArg(const Arg& arg) {
+  return arg;
+}
+
+inline std::string_view FormatArg(const char* string) {
+  return std::string_view(string);
+}
+
+template <typename Allocator, typename... Args>
+void FormatArgsTo(BasicString<Allocator>& string, const Args&... args) {
+  size_t old_len = string.length();
+  size_t new_len = old_len + (FormattedSize(args) + ... + 0);
+  string.resize_and_overwrite(new_len, [&](char* buffer, size_t /*unused*/) {
+    char* cur = buffer + old_len;
+    char* last = buffer + new_len;
+    ((cur = FormatInto(cur, last, args)), ...);
+    return static_cast<size_t>(cur - buffer);
+  });
+}
+
+template <typename Allocator, typename... Args>
+void FormatTo(BasicString<Allocator>& string, const Args&... args) {
+  FormatArgsTo(string, FormatArg(args)...);
+}
+
+template <typename Allocator = std::allocator<char>>
+class BasicStringBuilder {
+public:
+  BasicStringBuilder() = default;
+  BasicStringBuilder(const Allocator& alloc) : string_(alloc) {}
+
+  template <typename... Args>
+  BasicStringBuilder& append(const Args&... args);
+  template <typename Arg>
+  BasicStringBuilder& operator<<(const Arg& arg);
+
+  void reserve(size_t new_cap) { string_.reserve(new_cap + 1); }
+  void clear() { string_.clear(); }
+  size_t length() const { return string_.length(); }
+
+  const BasicString<Allocator>& str() const { return string_; }
+  BasicString<Allocator> release() { return std::move(string_); }
+
+private:
+  BasicString<Allocator> string_;
+};
+
+using StringBuilder = BasicStringBuilder<>;
+
+template <typename Allocator>
+template <typename... Args>
+BasicStringBuilder<Allocator>& BasicStringBuilder<Allocator>::append(
+    const Args&... args) {
+  FormatTo(string_, args...);
+  return *this;
+}
+
+template <typename Allocator>
+template <typename Arg>
+BasicStringBuilder<Allocator>& BasicStringBuilder<Allocator>::operator<<(
+    const Arg& arg) {
+  FormatTo(string_, arg);
+  return *this;
+}
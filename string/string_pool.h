@@ -0,0 +1,166 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "string.h"
+
+class InternedString {
+public:
+  InternedString() : entry_(&EmptyEntry()) {}
+
+  const char* data() const { return entry_->data; }
+  size_t length() const { return entry_->len; }
+  size_t size() const { return entry_->len; }
+  size_t hash() const { return entry_->hash; }
+  bool empty() const { return entry_->len == 0; }
+
+  String str() const {
+    String string;
+    string.append(entry_->data, entry_->len);
+    return string;
+  }
+
+  bool operator==(const InternedString& other) const {
+    return entry_ == other.entry_;
+  }
+
+private:
+  friend class StringPool;
+
+  struct Entry {
+    size_t hash;
+    size_t len;
+    const char* data;
+  };
+
+  const Entry* entry_;
+
+  InternedString(const Entry* entry) : entry_(entry) {}
+
+  static const Entry& EmptyEntry() {
+    static const Entry kEmptyEntry{HashBytes("", 0), 0, ""};
+    return kEmptyEntry;
+  }
+};
+
+class StringPool {
+public:
+  StringPool() = default;
+  StringPool(const StringPool& other) = delete;
+  StringPool& operator=(const StringPool& other) = delete;
+
+  InternedString intern(const char* chars, size_t len);
+  InternedString intern(const char* first_symbol_ptr);
+  InternedString intern(const String& string);
+
+  size_t size() const;
+  size_t bytes_allocated() const;
+
+private:
+  using Entry = InternedString::Entry;
+
+  struct IdentityHash {
+    size_t operator()(size_t hash) const { return hash; }
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_multimap<size_t, const Entry*, IdentityHash> table;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* chunk_top{nullptr};
+    size_t chunk_left{0};
+    size_t bytes_allocated{0};
+  };
+
+  static const size_t kShardsNum = 16;
+  static const size_t kChunkSz = 64 * 1024;
+
+  Shard shards_[kShardsNum];
+
+  static const Entry* create_entry(Shard& shard, const char* chars, size_t len,
+                                   size_t hash);
+};
+
+inline const InternedString::Entry* StringPool::create_entry(
+    Shard& shard, const char* chars, size_t len, size_t hash) {
+  size_t entry_sz = sizeof(Entry) + len + 1;
+  entry_sz = (entry_sz + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+  if (entry_sz > shard.chunk_left) {
+    size_t chunk_sz = entry_sz > kChunkSz ? entry_sz : kChunkSz;
+    shard.chunks.emplace_back(new char[chunk_sz]);
+    shard.chunk_top = shard.chunks.back().get();
+    shard.chunk_left = chunk_sz;
+    shard.bytes_allocated += chunk_sz;
+  }
+  char* symbols = shard.chunk_top + sizeof(Entry);
+  std::copy(chars, chars + len, symbols);
+  symbols[len] = '\0';
+  auto* entry = new (shard.chunk_top) Entry{hash, len, symbols};
+  shard.chunk_top += entry_sz;
+  shard.chunk_left -= entry_sz;
+  return entry;
+}
+
+inline InternedString StringPool::intern(const char* chars, size_t len) {
+  if (len == 0) {
+    return InternedString();
+  }
+  size_t hash = HashBytes(chars, len);
+  Shard& shard = shards_[(hash >> 32) % kShardsNum];
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto range = shard.table.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry* entry = it->second;
+    if (entry->len == len && std::memcmp(entry->data, chars, len) == 0) {
+      return InternedString(entry);
+    }
+  }
+  const Entry* entry = create_entry(shard, chars, len, hash);
+  shard.table.emplace(hash, entry);
+  return InternedString(entry);
+}
+
+inline InternedString StringPool::intern(const char* first_symbol_ptr) {
+  return intern(first_symbol_ptr, std::strlen(first_symbol_ptr));
+}
+
+inline InternedString StringPool::intern(const String& string) {
+  return intern(string.data(), string.length());
+}
+
+inline size_t StringPool::size() const {
+  size_t result = 0;
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.table.size();
+  }
+  return result;
+}
+
+inline size_t StringPool::bytes_allocated() const {
+  size_t result = 0;
+  for (const Shard& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.bytes_allocated;
+  }
+  return result;
+}
+
+inline bool operator!=(const InternedString& lhs, const InternedString& rhs) {
+  return !(lhs == rhs);
+}
+
+inline std::ostream& operator<<(std::ostream& out,
+                                const InternedString& string) {
+  return out.write(string.data(), string.length());
+}
+
+template <>
+struct std::hash<InternedString> {
+  size_t operator()(const InternedString& string) const noexcept {
+    return string.hash();
+  }
+};
@@ -0,0 +1,275 @@
+#pragma once
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#include "string.h"
+
+inline constexpr uint64_t kHighBitsMask = 0x8080808080808080ULL;
+inline constexpr char32_t kReplacementCodePoint = 0xFFFD;
+
+inline uint64_t ReadWord(const char* ptr) {
+  uint64_t word;
+  std::memcpy(&word, ptr, sizeof(word));
+  return word;
+}
+
+inline size_t DecodeUtf8(const char* bytes, size_t len,
+                         char32_t& code_point) {
+  auto lead = static_cast<unsigned char>(bytes[0]);
+  if (lead < 0x80) {
+    code_point = lead;
+    return 1;
+  }
+  size_t seq_len = 0;
+  char32_t min_code_point = 0;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    seq_len = 2;
+    code_point = lead & 0x1F;
+    min_code_point = 0x80;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    seq_len = 3;
+    code_point = lead & 0x0F;
+    min_code_point = 0x800;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    seq_len = 4;
+    code_point = lead & 0x07;
+    min_code_point = 0x10000;
+  } else {
+    code_point = kReplacementCodePoint;
+    return 0;
+  }
+  if (seq_len > len) {
+    code_point = kReplacementCodePoint;
+    return 0;
+  }
+  for (size_t i = 1; i < seq_len; ++i) {
+    auto byte = static_cast<unsigned char>(bytes[i]);
+    if ((byte & 0xC0) != 0x80) {
+      code_point = kReplacementCodePoint;
+      return 0;
+    }
+    code_point = (code_point << 6) | (byte & 0x3F);
+  }
+  if (code_point < min_code_point || code_point > 0x10FFFF ||
+      (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+    code_point = kReplacementCodePoint;
+    return 0;
+  }
+  return seq_len;
+}
+
+inline bool IsValidUtf8(const char* bytes, size_t len) {
+  size_t pos = 0;
+  while (pos < len) {
+    while (pos + sizeof(uint64_t) <= len &&
+           (ReadWord(bytes + pos) & kHighBitsMask) == 0) {
+      pos += sizeof(uint64_t);
+    }
+    if (pos == len) {
+      break;
+    }
+    char32_t code_point;
+    size_t seq_len = DecodeUtf8(bytes + pos, len - pos, code_point);
+    if (seq_len == 0) {
+      return false;
+    }
+    pos += seq_len;
+  }
+  return true;
+}
+
+inline size_t CountCodePoints(const char* bytes, size_t len) {
+  size_t continuation_count = 0;
+  size_t pos = 0;
+  for (; pos + sizeof(uint64_t) <= len; pos += sizeof(uint64_t)) {
+    uint64_t word = ReadWord(bytes + pos);
+    continuation_count += std::popcount(word & ~(word << 1) & kHighBitsMask);
+  }
+  for (; pos < len; ++pos) {
+    if ((static_cast<unsigned char>(bytes[pos]) & 0xC0) == 0x80) {
+      ++continuation_count;
+    }
+  }
+  return len - continuation_count;
+}
+
+inline char32_t FoldCase(char32_t code_point) {
+  if (code_point < 0x80) {
+    if (code_point >= 'A' && code_point <= 'Z') {
+      return code_point + ('a' - 'A');
+    }
+    return code_point;
+  }
+  if (code_point >= 0xC0 && code_point <= 0xDE && code_point != 0xD7) {
+    return code_point + 0x20;
+  }
+  if (code_point == 0xB5) {
+    return 0x3BC;
+  }
+  if (code_point == 0x178) {
+    return 0xFF;
+  }
+  if (code_point == 0x17F) {
+    return 's';
+  }
+  if (code_point >= 0x100 && code_point <= 0x17F) {
+    if ((code_point >= 0x139 && code_point <= 0x148) ||
+        (code_point >= 0x179 && code_point <= 0x17E)) {
+      return (code_point % 2 == 1) ? code_point + 1 : code_point;
+    }
+    if (code_point != 0x130 && code_point != 0x131 && code_point != 0x138 &&
+        code_point != 0x149 && code_point != 0x17F) {
+      return (code_point % 2 == 0) ? code_point + 1 : code_point;
+    }
+    return code_point;
+  }
+  if (code_point == 0x386) {
+    return 0x3AC;
+  }
+  if (code_point >= 0x388 && code_point <= 0x38A) {
+    return code_point + 0x25;
+  }
+  if (code_point == 0x38C) {
+    return 0x3CC;
+  }
+  if (code_point == 0x38E || code_point == 0x38F) {
+    return code_point + 0x3F;
+  }
+  if (code_point >= 0x391 && code_point <= 0x3AB && code_point != 0x3A2) {
+    return code_point + 0x20;
+  }
+  if (code_point == 0x3C2) {
+    return 0x3C3;
+  }
+  if (code_point >= 0x400 && code_point <= 0x40F) {
+    return code_point + 0x50;
+  }
+  if (code_point >= 0x410 && code_point <= 0x42F) {
+    return code_point + 0x20;
+  }
+  if ((code_point >= 0x460 && code_point <= 0x481) ||
+      (code_point >= 0x48A && code_point <= 0x4BF)) {
+    return (code_point % 2 == 0) ? code_point + 1 : code_point;
+  }
+  return code_point;
+}
+
+class Utf8View {
+public:
+  class iterator;
+
+  Utf8View(const char* bytes, size_t len) : bytes_(bytes), len_(len) {}
+  template <typename Allocator>
+  Utf8View(const BasicString<Allocator>& string)
+      : bytes_(string.data()), len_(string.length()) {}
+
+  iterator begin() const;
+  iterator end() const;
+
+private:
+  const char* bytes_;
+  size_t len_;
+};
+
+class Utf8View::iterator {
+public:
+  using value_type = char32_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const char32_t*;
+  using reference = char32_t;
+  using iterator_category = std::input_iterator_tag;
+  using iterator_concept = std::forward_iterator_tag;
+
+  iterator() = default;
+  iterator(const char* cur, const char* last) : cur_(cur), last_(last) {}
+
+  char32_t operator*() const;
+  iterator& operator++();
+  iterator operator++(int);
+
+  bool operator==(const iterator& iter) const { return cur_ == iter.cur_; }
+
+  const char* base() const { return cur_; }
+
+private:
+  const char* cur_{nullptr};
+  const char* last_{nullptr};
+};
+
+inline Utf8View::iterator Utf8View::begin() const {
+  return {bytes_, bytes_ + len_};
+}
+
+inline Utf8View::iterator Utf8View::end() const {
+  return {bytes_ + len_, bytes_ + len_};
+}
+
+inline char32_t Utf8View::iterator::operator*() const {
+  char32_t code_point;
+  DecodeUtf8(cur_, last_ - cur_, code_point);
+  return code_point;
+}
+
+inline Utf8View::iterator& Utf8View::iterator::operator++() {
+  char32_t code_point;
+  size_t seq_len = DecodeUtf8(cur_, last_ - cur_, code_point);
+  cur_ += (seq_len == 0 ? 1 : seq_len);
+  return *this;
+}
+
+inline Utf8View::iterator Utf8View::iterator::operator++(int) {
+  iterator tmp(*this);
+  ++*this;
+  return tmp;
+}
+
+inline std::weak_ordering CompareCaseFolded(const char* bytes1, size_t len1,
+                                            const char* bytes2, size_t len2) {
+  size_t pos1 = 0;
+  size_t pos2 = 0;
+  while (pos1 < len1 && pos2 < len2) {
+    char32_t code_point1;
+    char32_t code_point2;
+    size_t seq_len1 = DecodeUtf8(bytes1 + pos1, len1 - pos1, code_point1);
+    size_t seq_len2 = DecodeUtf8(bytes2 + pos2, len2 - pos2, code_point2);
+    code_point1 = FoldCase(code_point1);
+    code_point2 = FoldCase(code_point2);
+    if (code_point1 != code_point2) {
+      return code_point1 <=> code_point2;
+    }
+    pos1 += (seq_len1 == 0 ? 1 : seq_len1);
+    pos2 += (seq_len2 == 0 ? 1 : seq_len2);
+  }
+  bool is_rest1 = pos1 < len1;
+  bool is_rest2 = pos2 < len2;
+  if (is_rest1 == is_rest2) {
+    return std::weak_ordering::equivalent;
+  }
+  return is_rest1 ? std::weak_ordering::greater : std::weak_ordering::less;
+}
+
+template <typename Allocator>
+bool IsValidUtf8(const BasicString<Allocator>& string) {
+  return IsValidUtf8(string.data(), string.length());
+}
+
+template <typename Allocator>
+size_t CountCodePoints(const BasicString<Allocator>& string) {
+  return CountCodePoints(string.data(), string.length());
+}
+
+template <typename Allocator>
+std::weak_ordering CompareCaseFolded(const BasicString<Allocator>& string1,
+                                     const BasicString<Allocator>& string2) {
+  return CompareCaseFolded(string1.data(), string1.length(), string2.data(),
+                           string2.length());
+}
+
+template <typename Allocator>
+bool EqualsCaseFolded(const BasicString<Allocator>& string1,
+                      const BasicString<Allocator>& string2) {
+  return std::is_eq(CompareCaseFolded(string1, string2));
+}